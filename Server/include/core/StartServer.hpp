@@ -11,30 +11,40 @@
 #include "gamelogic/GameSession.hpp"
 #include "network/protocol/Protocole.hpp"
 #include "network/tcp/TcpServer.hpp"
+#include "serverloop/GameInstancePool.hpp"
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sys/types.h>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
-/** @brief Tracks a running game server instance (forked child process) */
+/** @brief Tracks a running game server instance
+ *
+ * A forked child process, or a game of the in-process pool when
+ * process_id is 0. Pool games share one UDP port and are told apart by
+ * their session token. */
 struct GameInstance {
     uint16_t lobby_id;          ///< Lobby identifier
     uint16_t server_id;         ///< Unique server instance ID
     pid_t process_id;           ///< Child process PID
     uint16_t udp_port;          ///< Allocated UDP port for game traffic
     uint32_t server_ip;         ///< Server IP address
+    uint64_t session_token;     ///< Shared port session, 0 on an own port
     std::vector<ClientId> player_ids; ///< Players in this game
 
     GameInstance()
-        : lobby_id(0), server_id(0), process_id(0), udp_port(0), server_ip(0) {}
+        : lobby_id(0), server_id(0), process_id(0), udp_port(0), server_ip(0),
+          session_token(0) {}
 
     GameInstance(uint16_t lid, uint16_t sid, pid_t pid, uint16_t port,
                  uint32_t ip)
         : lobby_id(lid), server_id(sid), process_id(pid), udp_port(port),
-          server_ip(ip) {}
+          server_ip(ip), session_token(0) {}
 };
 
 /**
@@ -47,8 +57,15 @@ class StartServer {
   public:
     /** @brief Initializes lobby server
      * @param port TCP port for lobby connections
-     * @param base_udp_port Base port for allocating UDP game servers */
-    StartServer(int port, int base_udp_port);
+     * @param base_udp_port Base port for allocating UDP game servers
+     * @param tick_rate Simulation rate of game instances in Hz
+     * @param broadcast_rate Entity update send rate of game instances in Hz
+     * @param game_workers Threads running games in process, 0 to fork per game
+     * @param udp_shards SO_REUSEPORT receive sockets of the shared port, in process only
+     * @param warm_instances Idle games kept open for the next lobbies, in process only */
+    StartServer(int port, int base_udp_port, uint32_t tick_rate = 60,
+                uint32_t broadcast_rate = 60, uint32_t game_workers = 0,
+                uint32_t udp_shards = 1, uint32_t warm_instances = 0);
 
     ~StartServer();
 
@@ -65,10 +82,22 @@ class StartServer {
     // Server configuration
     int _tcp_port;
     int _base_udp_port;
+    uint32_t _tick_rate;
+    uint32_t _broadcast_rate;
     uint16_t _next_server_id;
 
     // Server components
     std::unique_ptr<TCPServer> _tcp_server;
+    std::unique_ptr<UDPServer> _shared_port;          // Null in fork mode
+    std::unique_ptr<GameInstancePool> _instance_pool; // Null in fork mode
+    // Opened but not yet assigned games, handed to the next lobbies to start.
+    // Built by _warm_builder and taken by the lobby loop, both under _warm_mutex
+    std::vector<std::unique_ptr<GameServerLoop>> _warm_instances;
+    std::size_t _warm_target;
+    std::mutex _warm_mutex;
+    std::condition_variable _warm_cv; // Signaled when a game is taken or on stop
+    bool _warm_stopping = false;
+    std::thread _warm_builder;
     Protocol _protocol;
     GameSession _game_session;
 
@@ -135,11 +164,25 @@ class StartServer {
     /** @brief Releases UDP port back to pool */
     void freeUdpPort(uint16_t port);
 
-    /** @brief Forks child process to run game server for lobby
+    /** @brief Starts the game server of a lobby, forked or in the pool
      * @return True if started successfully */
     bool startGameInstance(uint16_t lobby_id);
 
-    /** @brief Reaps finished child processes and frees resources */
+    /** @brief Takes a warm game, or opens one as a session of the shared port
+     * @return Null if no session could be opened */
+    std::unique_ptr<GameServerLoop> takeGameInstance();
+
+    /** @brief Opens a game ahead of time, sized for a full lobby
+     * @return Null if its session could not be opened */
+    std::unique_ptr<GameServerLoop> openGameInstance();
+
+    /** @brief Keeps the warm stock at target, off the lobby thread */
+    void warmBuilderLoop();
+
+    /** @brief Stops and joins the warm builder */
+    void stopWarmBuilder();
+
+    /** @brief Reaps finished child processes and pool games, frees resources */
     void cleanupFinishedGames();
 
     // Broadcasting
@@ -9,11 +9,12 @@
 #define GAMELOGIC_COMPLETE_HPP_
 
 #include "../../ecs/include/registery.hpp"
+#include "network/CompactEntityCodec.hpp"
+#include "network/messages/RingQueue.hpp"
+#include "network/protocol/UdpMessageType.hpp"
+#include <array>
 #include <chrono>
-#include <deque>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <random>
 #include <sys/types.h>
 #include <unordered_map>
@@ -133,8 +134,8 @@ struct Hitbox {
 
 struct NetworkComponent {
     uint net_id;
-    bool needs_update;
-    std::string entity_type; // "player", "enemy", "projectile", "boss"
+    uint8_t dirty_fields; // network::EntityField bits written since the last sync
+    EntityType entity_type; // Set once at spawn, sent as is
 };
 
 // Event structure with timestamp and sequence
@@ -148,7 +149,7 @@ struct ClientEvent {
 // Entity state snapshot for network sync
 struct EntitySnapshot {
     uint net_id;
-    std::string entity_type;
+    EntityType entity_type;
     Position pos;
     Velocity vel;
     int health;
@@ -164,12 +165,35 @@ struct WorldSnapshot {
     std::vector<EntitySnapshot> entities;
 };
 
+// Compact per-entity state kept in the snapshot ring (no heap members)
+struct EntityState {
+    uint net_id;
+    EntityType type;
+    float x;
+    float y;
+    int health;
+    int shield;
+    int score;
+    uint8_t flags;
+    // network::EntityField bits: written since the previous capture when stored
+    // in the ring, changed since the client's baseline in a delta
+    uint8_t fields;
+};
+
+// One tick of the snapshot ring, entities sorted by net_id
+struct SnapshotFrame {
+    uint tick = 0;
+    bool valid = false;
+    std::vector<EntityState> entities;
+};
+
 /**
  * @brief Class to handle the game logic for R-Type multiplayer server
  */
 class GameLogic {
   public:
-    GameLogic(std::shared_ptr<registry> reg, uint8_t level_id = 1);
+    GameLogic(std::shared_ptr<registry> reg, uint8_t level_id = 1,
+              uint32_t tick_rate = 60);
     ~GameLogic();
 
     // Game loop control
@@ -179,9 +203,13 @@ class GameLogic {
     /** @brief Stops the game loop */
     void stop();
 
-    /** @brief Updates game state with fixed timestep
-     * @param deltaTime Time elapsed since last frame in seconds */
-    void update(float deltaTime);
+    /** @brief Runs exactly one fixed simulation tick
+     *
+     * The caller paces ticks itself (see TickScheduler) */
+    void step();
+
+    /** @brief Duration of one simulation tick in seconds */
+    float getTickDuration() const { return _fixed_timestep; }
 
     /** @brief Debug helper to print all entity positions */
     void printEntityPositions();
@@ -191,17 +219,41 @@ class GameLogic {
      * @param evt Client input event to process */
     void pushClientEvent(const ClientEvent &evt);
 
+    /** @brief Overwrites a player's held buttons from an INPUT_STATE frame
+     *
+     * Game thread only, bypasses the event queue
+     * @param client_id Client whose player to update
+     * @param buttons network::InputButton bits of the newest frame
+     * @param fire True if any newly received frame had INPUT_SHOOT set */
+    void applyInputState(uint client_id, uint8_t buttons, bool fire);
+
     // Snapshot management
     /** @brief Creates a snapshot of current world state
      * @return Full world snapshot with all entities */
     WorldSnapshot generateSnapshot();
 
-    /** @brief Generates delta snapshot since last acknowledged tick
-     * @param last_acked_tick Last tick client confirmed receiving
-     * @return List of entities that changed since last_acked_tick */
-    std::vector<EntitySnapshot> getDeltaSnapshot(uint last_acked_tick);
+    /** @brief Records the current world state in the snapshot ring
+     * @return Tick of the recorded snapshot */
+    uint captureSnapshot();
+
+    /** @brief Entities of the latest captured snapshot that changed since a baseline
+     *
+     * A field is only compared when a frame captured after the baseline has it
+     * dirty, and each returned state carries the fields that actually changed.
+     * @param last_acked_tick Last tick the client confirmed receiving (0 = none)
+     * @param out Filled with the changed entities, or every entity if the
+     *            baseline is no longer in the ring */
+    void getDeltaSnapshot(uint last_acked_tick, std::vector<EntityState> &out) const;
 
-    /** @brief Clears needs_update flags on all networked entities */
+    /** @brief Returns true if the tick is still available as a delta baseline */
+    bool hasSnapshot(uint tick) const;
+
+    /** @brief Entities of the latest captured snapshot, sorted by net_id */
+    const std::vector<EntityState> &getLatestSnapshot() const {
+        return _snapshot_ring[_last_snapshot_tick % SNAPSHOT_RING_SIZE].entities;
+    }
+
+    /** @brief Clears dirty field masks once captureSnapshot() recorded them */
     void markEntitiesSynced();
 
     // Player management
@@ -222,6 +274,12 @@ class GameLogic {
      * @return Entity handle or invalid entity if not found */
     entity getPlayerEntity(uint client_id);
 
+    /** @brief Reads the position of a client's player
+     * @param client_id Client to lookup
+     * @param out Set to the player position (normalized 0.0-1.0)
+     * @return False if the client has no player */
+    bool getPlayerPosition(uint client_id, Position &out);
+
     // Getters
     /** @brief Current server tick counter */
     uint getCurrentTick() const { return _current_tick; }
@@ -230,9 +288,11 @@ class GameLogic {
      * @return Monotonically increasing network ID */
     uint generateNetId();
 
-    /** @brief Returns and clears list of destroyed entity net IDs
-     * @return List of net IDs destroyed since last call */
-    std::vector<uint> getDestroyedEntities();
+    /** @brief Hands over the net IDs destroyed since the last call
+     *
+     * Buffers are swapped, not copied, so both keep their capacity
+     * @param out Replaced by the destroyed net IDs */
+    void getDestroyedEntities(std::vector<uint> &out);
 
     // Game state checks
     /** @brief Checks if game is over (no players left) */
@@ -244,23 +304,40 @@ class GameLogic {
     /** @brief Checks if level is complete (boss defeated) */
     bool isLevelComplete() const { return _level_complete; }
 
+    /** @brief Changes the level of a game built ahead of time, before start() */
+    void setLevel(uint8_t level_id) {
+        _level_id = level_id;
+        _endless_mode = level_id == 99;
+    }
+
     /** @brief Information about newly spawned entities for network sync */
     struct NewEntityInfo {
         uint net_id;           ///< Network identifier
-        std::string entity_type; ///< Entity type ("player", "enemy", "boss", etc.)
+        EntityType entity_type;  ///< Protocol entity type
         float x, y;            ///< Spawn position (normalized 0.0-1.0)
         int health;            ///< Initial health points
         int shield;            ///< Initial shield points
+        float vx = 0.0f;       ///< Velocity (projectiles only, units per second)
+        float vy = 0.0f;
+        uint spawn_tick = 0;   ///< Tick at which the entity was at (x, y)
     };
 
-    /** @brief Returns and clears list of newly spawned entities
-     * @return List of entities created since last call */
-    std::vector<NewEntityInfo> getNewEntities();
+    /** @brief Hands over the entities spawned since the last call
+     *
+     * Buffers are swapped, not copied, so both keep their capacity
+     * @param out Replaced by the new entities */
+    void getNewEntities(std::vector<NewEntityInfo> &out);
+
+    /** @brief Lists live projectiles with their position at the current tick
+     *
+     * Lets a joining client start simulating projectiles already in flight
+     * @param out Filled with one entry per projectile */
+    void getLiveProjectiles(std::vector<NewEntityInfo> &out) const;
 
   private:
     std::shared_ptr<registry> _registry;
-    std::queue<ClientEvent> _event_queue;
-    std::mutex _event_mutex;
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 1024;
+    MpscRing<ClientEvent> _event_queue{EVENT_QUEUE_CAPACITY};
     std::unordered_map<uint, entity> _client_to_entity;
     bool _running;
 
@@ -268,15 +345,18 @@ class GameLogic {
     uint _current_tick;
     std::chrono::steady_clock::time_point _last_update;
 
-    // Snapshot history
-    static const size_t MAX_SNAPSHOT_HISTORY = 128;
-    std::deque<WorldSnapshot> _snapshot_history;
+    // Snapshot ring, indexed by tick % SNAPSHOT_RING_SIZE. Frames are reserved
+    // up front and reused in place, capturing only allocates past the reserve
+    static const size_t SNAPSHOT_RING_SIZE = 128;
+    static const size_t SNAPSHOT_ENTITY_RESERVE = 256;
+    std::array<SnapshotFrame, SNAPSHOT_RING_SIZE> _snapshot_ring;
+    uint _last_snapshot_tick = 0;
 
     // Game state
     float _game_time;
     float _enemy_spawn_timer;
     float _enemy_spawn_interval;
-    float _accumulator;    // For fixed timestep
+    float _fixed_timestep; // Duration of one tick (1 / tick rate)
     float _debug_timer;    // For debug output
     int _total_score;
     bool _boss_spawned;
@@ -307,6 +387,14 @@ class GameLogic {
     std::mt19937 _rng;
     uint _next_net_id;
 
+    // Dense net_id <-> entity index, kept by addNetworkComponent/destroyEntity
+    struct NetEntity {
+        uint net_id;
+        entity ent;
+    };
+    std::vector<NetEntity> _net_entities;
+    std::unordered_map<uint, size_t> _net_id_slots; // net_id -> _net_entities index
+
     // Logic methods
     /** @brief Processes queued client input events */
     void processEvents();
@@ -405,21 +493,31 @@ class GameLogic {
      * @return Entity handle or invalid entity if not found */
     entity findEntityByNetId(uint net_id);
 
+    /** @brief Adds the NetworkComponent of a new entity and indexes its net_id
+     * @param ent Freshly spawned entity
+     * @param net_id Network ID from generateNetId()
+     * @param type Protocol entity type */
+    void addNetworkComponent(entity ent, uint net_id, EntityType type);
+
+    /** @brief Kills an entity and drops it from the net_id index
+     *
+     * Does not queue an ENTITY_DESTROY, callers record _destroyed_net_ids
+     * @param ent Entity to kill */
+    void destroyEntity(entity ent);
+
     // Helper methods for collision system
     /** @brief Handles projectile vs entity collisions and damage */
     static void processProjectileCollisions(
         registry &reg, sparse_array<Position> &positions,
         sparse_array<Hitbox> &hitboxes, sparse_array<Projectile> &projectiles,
         sparse_array<PlayerComponent> &players, sparse_array<Enemy> &enemies,
-        sparse_array<Health> &healths, sparse_array<Score> &scores,
-        sparse_array<NetworkComponent> &network_comps);
+        sparse_array<Health> &healths, sparse_array<Score> &scores);
 
     /** @brief Handles player-enemy contact damage */
     static void processContactCollisions(
         registry &reg, sparse_array<Position> &positions,
         sparse_array<Hitbox> &hitboxes, sparse_array<PlayerComponent> &players,
-        sparse_array<Enemy> &enemies, sparse_array<Health> &healths,
-        sparse_array<NetworkComponent> &network_comps);
+        sparse_array<Enemy> &enemies, sparse_array<Health> &healths);
 
     /** @brief Applies damage with shield absorption
      * @param reg Registry reference
@@ -428,6 +526,12 @@ class GameLogic {
      * @return Remaining damage after shield absorption */
     static int applyDamageWithShield(registry &reg, size_t entity_idx, int damage);
 
+    /** @brief Flags fields of a networked entity as written this tick
+     * @param reg Registry holding the entity
+     * @param entity_idx Entity index
+     * @param fields network::EntityField bits */
+    static void markDirty(registry &reg, size_t entity_idx, uint8_t fields);
+
     // Helper methods for boss shooting
     /** @brief Handles level 2 boss (3-part) shooting patterns */
     void processBossLevel2Shooting(float dt);
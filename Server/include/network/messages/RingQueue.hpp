@@ -0,0 +1,174 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** RingQueue - Bounded lock-free queues between network threads and game loop
+*/
+
+#ifndef RINGQUEUE_HPP_
+#define RINGQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ring_detail {
+
+inline std::size_t roundUpPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Keeps producer and consumer indices on separate cache lines
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+}  // namespace ring_detail
+
+/**
+ * @brief Bounded single-producer / single-consumer ring
+ *
+ * Slots are allocated once and never destroyed while the ring lives, so
+ * members such as std::string keep their capacity from one use to the next.
+ * Producers fill a slot in place and the consumer reads it in place.
+ */
+template <typename T>
+class SpscRing {
+  public:
+    explicit SpscRing(std::size_t capacity)
+        : _mask(ring_detail::roundUpPowerOfTwo(capacity) - 1),
+          _slots(new T[_mask + 1]) {}
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Fill the next free slot with fill(T&), producer thread only
+     * @return false if the ring is full, the slot is left untouched
+     */
+    template <typename Fill>
+    bool tryPush(Fill &&fill) {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) > _mask) {
+            return false;
+        }
+
+        fill(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Hand every queued slot to consume(T&), consumer thread only
+     * @return Number of slots consumed
+     */
+    template <typename Consume>
+    std::size_t drain(Consume &&consume) {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        std::size_t head = _head.load(std::memory_order_acquire);
+        std::size_t count = head - tail;
+
+        for (; tail != head; ++tail) {
+            consume(_slots[tail & _mask]);
+            _tail.store(tail + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+  private:
+    const std::size_t _mask;
+    std::unique_ptr<T[]> _slots;
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<std::size_t> _head{0};
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{0};
+};
+
+/**
+ * @brief Bounded multi-producer / single-consumer ring
+ *
+ * Each slot carries a sequence number telling producers and the consumer
+ * whose turn it is, so producers only contend on the head index.
+ */
+template <typename T>
+class MpscRing {
+  public:
+    explicit MpscRing(std::size_t capacity)
+        : _mask(ring_detail::roundUpPowerOfTwo(capacity) - 1),
+          _slots(new Slot[_mask + 1]) {
+        for (std::size_t i = 0; i <= _mask; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /**
+     * @brief Claim a slot and fill it with fill(T&), any thread
+     * @return false if the ring is full
+     */
+    template <typename Fill>
+    bool tryPush(Fill &&fill) {
+        std::size_t pos = _head.load(std::memory_order_relaxed);
+
+        while (true) {
+            Slot &slot = _slots[pos & _mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) -
+                        static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Hand queued slots to consume(T&), consumer thread only
+     *
+     * Stops after one ring's worth so busy producers cannot keep the
+     * consumer here forever.
+     * @return Number of slots consumed
+     */
+    template <typename Consume>
+    std::size_t drain(Consume &&consume) {
+        std::size_t count = 0;
+
+        while (count <= _mask) {
+            Slot &slot = _slots[_tail & _mask];
+            if (slot.sequence.load(std::memory_order_acquire) != _tail + 1) {
+                break;
+            }
+
+            consume(slot.value);
+            slot.sequence.store(_tail + _mask + 1, std::memory_order_release);
+            ++_tail;
+            ++count;
+        }
+        return count;
+    }
+
+  private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<std::size_t> _head{0};
+    alignas(ring_detail::CACHE_LINE_SIZE) std::size_t _tail = 0;
+};
+
+#endif /* !RINGQUEUE_HPP_ */
@@ -0,0 +1,56 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** FrameBuilder.hpp
+*/
+
+#ifndef FRAMEBUILDER_HPP_
+#define FRAMEBUILDER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Packs the UDP messages sent to one client during a tick into datagrams
+ *
+ * Messages are concatenated whole (each keeps its own 8-byte header) until
+ * the next one would push the datagram past MAX_DATAGRAM_SIZE. A message
+ * larger than that is sent alone. Datagram buffers are kept between ticks
+ * so steady-state building does not allocate.
+ */
+class FrameBuilder {
+  public:
+    /** @brief Stays under the common 1280-byte IPv6 minimum MTU with room for headers */
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 1200;
+
+    FrameBuilder() = default;
+
+    /** @brief Starts a new frame
+     * @param aggregate False to put every message in its own datagram, for
+     *                  clients that only read one message per datagram */
+    void reset(bool aggregate);
+
+    /** @brief Appends a serialized UDP message to the frame */
+    void append(const std::string &message);
+
+    /** @brief Number of datagrams in the frame */
+    std::size_t size() const { return _count; }
+
+    /** @brief Returns true if nothing was appended since reset() */
+    bool empty() const { return _count == 0; }
+
+    /** @brief Datagram at index, valid until the next reset() */
+    const std::string &datagram(std::size_t index) const { return _datagrams[index]; }
+
+  private:
+    /** @brief Opens the next datagram, reusing a buffer from a previous tick */
+    std::string &nextDatagram();
+
+    std::vector<std::string> _datagrams;
+    std::size_t _count = 0;
+    bool _aggregate = true;
+};
+
+#endif /* !FRAMEBUILDER_HPP_ */
@@ -33,7 +33,8 @@ class Protocol {
     std::string createConnectNak(ConnectError error_code);
     std::string createReady();
     std::string createGameStart(uint16_t udp_port, uint16_t server_id,
-                                uint32_t server_ip, uint8_t level_id = 1);
+                                uint32_t server_ip, uint8_t level_id = 1,
+                                uint64_t session_token = 0);
 
     // Lobby Navigation Messages
     std::string createLobbyListRequest();
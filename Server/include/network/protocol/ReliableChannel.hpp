@@ -0,0 +1,68 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** ReliableChannel.hpp
+*/
+
+#ifndef RELIABLECHANNEL_HPP_
+#define RELIABLECHANNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+/**
+ * @brief Reliable-ordered delivery of event messages to one client
+ *
+ * Each message sent through the channel gets the next channel sequence
+ * (from 1) in its SEQUENCE_NUM header field, and a copy is kept until the
+ * client acknowledges it. Clients acknowledge with the highest sequence
+ * received in order plus a bitfield of the 32 sequences after the first
+ * gap, piggybacked on SNAPSHOT_ACK. Messages that stay unacknowledged are
+ * resent one by one; the client drops duplicates and delivers in order.
+ */
+class ReliableChannel {
+  public:
+    ReliableChannel() = default;
+
+    /** @brief Stamps a serialized message with the next channel sequence
+     * @param message Serialized UDP message, header included
+     * @param tick Current server tick, starts the resend timer
+     * @return The stamped copy to send now, valid until the next call */
+    const std::string &send(const std::string &message, uint32_t tick);
+
+    /** @brief Releases the messages the client confirmed
+     * @param delivered Every sequence up to this one was received
+     * @param received_bits Bit i set if sequence delivered + 2 + i was received */
+    void acknowledge(uint32_t delivered, uint32_t received_bits);
+
+    /** @brief Hands each message unacknowledged for resend_ticks to resend(const std::string&)
+     * @param tick Current server tick
+     * @param resend_ticks Ticks to wait for an acknowledgement before resending */
+    template <typename Resend>
+    void resendExpired(uint32_t tick, uint32_t resend_ticks, Resend &&resend) {
+        for (Entry &entry : _entries) {
+            if (tick - entry.sent_tick >= resend_ticks) {
+                entry.sent_tick = tick;
+                resend(entry.message);
+            }
+        }
+    }
+
+    /** @brief Number of messages waiting for an acknowledgement */
+    std::size_t pending() const { return _entries.size(); }
+
+  private:
+    struct Entry {
+        uint32_t sequence;
+        uint32_t sent_tick;
+        std::string message;
+    };
+
+    std::deque<Entry> _entries; // Ascending sequence
+    uint32_t _next_sequence = 1;
+};
+
+#endif /* !RELIABLECHANNEL_HPP_ */
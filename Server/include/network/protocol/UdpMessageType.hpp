@@ -18,7 +18,13 @@ enum UdpMessageType : uint8_t {
     ENTITY_UPDATE = 0x11,
     ENTITY_DESTROY = 0x12,
     GAME_STATE = 0x13,
+    ENTITY_UPDATE_COMPACT = 0x14,
+    PROJECTILE_SPAWN = 0x15,
+    INPUT_ACK = 0x16,
+    ENTITY_DEFERRED = 0x17,
     PLAYER_INPUT = 0x20,
+    SNAPSHOT_ACK = 0x21,
+    INPUT_STATE = 0x22,
     VICTORY = 0x30
 };
 
@@ -56,9 +62,21 @@ enum Direction : uint8_t {
 
 // Constants
 static constexpr std::size_t UDP_HEADER_SIZE = 8;
+static constexpr std::size_t PLAYER_ASSIGNMENT_SIZE = 5; // net_id + tick rate
 static constexpr std::size_t ENTITY_CREATE_SIZE = 21;
 static constexpr std::size_t ENTITY_UPDATE_SIZE = 26;
 static constexpr std::size_t ENTITY_DESTROY_SIZE = 4;
+static constexpr std::size_t SNAPSHOT_TICK_SIZE = 4;
+static constexpr std::size_t UPDATE_HEADER_SIZE = 6; // Snapshot tick + chunk index and count
+static constexpr std::size_t SNAPSHOT_ACK_SIZE = 4;
+static constexpr std::size_t SNAPSHOT_ACK_RELIABLE_SIZE = 12; // + reliable ack and bits
+static constexpr std::size_t CLIENT_PING_SIZE = 4;
+static constexpr std::size_t CLIENT_PING_CAPS_SIZE = 5; // + capability byte
+static constexpr std::size_t PROJECTILE_SPAWN_HEADER_SIZE = 5; // server tick + tick rate
+static constexpr std::size_t PROJECTILE_SPAWN_SIZE = 25;
+static constexpr std::size_t INPUT_FRAME_SIZE = 5; // input sequence + buttons
+static constexpr std::size_t INPUT_STATE_MAX_FRAMES = 8;
+static constexpr std::size_t INPUT_ACK_SIZE = 8; // snapshot tick + input sequence
 
 // UDP Header structure
 struct UdpHeader {
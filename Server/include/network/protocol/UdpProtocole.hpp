@@ -9,6 +9,8 @@
 #define UDPPROTOCOLE_HPP_
 
 #include "UdpMessageType.hpp"
+#include "network/CompactEntityCodec.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -20,6 +22,31 @@ struct ParsedUdpMessage {
     bool valid;
 };
 
+// Non-owning view over payload bytes (std::span stand-in, the tree is C++17)
+struct UdpPayloadView {
+    const uint8_t *ptr = nullptr;
+    size_t length = 0;
+
+    UdpPayloadView() = default;
+    UdpPayloadView(const uint8_t *data, size_t size) : ptr(data), length(size) {}
+    UdpPayloadView(const std::vector<uint8_t> &data)
+        : ptr(data.data()), length(data.size()) {}
+
+    const uint8_t *data() const { return ptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    uint8_t operator[](size_t i) const { return ptr[i]; }
+};
+
+// Same as ParsedUdpMessage but pointing into the received buffer, which must
+// outlive it
+struct UdpMessageView {
+    UdpMessageType type;
+    uint32_t sequence_num;
+    UdpPayloadView data;
+    bool valid;
+};
+
 struct Entity {
     uint32_t net_id;
     EntityType type;
@@ -29,6 +56,24 @@ struct Entity {
     float position_y;
     uint32_t score;
     uint8_t flags = 0;
+    uint8_t fields = network::FIELD_ALL; // Only encoded in compact updates
+};
+
+// One sampled input frame from INPUT_STATE (network::InputButton bits)
+struct InputFrame {
+    uint32_t sequence;
+    uint8_t buttons;
+};
+
+// Straight-line projectile, clients move it themselves from these values
+struct ProjectileSpawn {
+    uint32_t net_id;
+    EntityType type;
+    uint32_t spawn_tick; // Tick at which the projectile was at the origin
+    float origin_x;
+    float origin_y;
+    float velocity_x; // Normalized units per second
+    float velocity_y;
 };
 
 class UdpProtocole {
@@ -37,18 +82,44 @@ class UdpProtocole {
     ~UdpProtocole() = default;
 
     ParsedUdpMessage parseMessage(const std::string &raw_message);
+    UdpMessageView parseMessageView(const uint8_t *raw, size_t size);
 
-    std::string createPlayerAssignment(uint32_t player_net_id,
+    std::string createPlayerAssignment(uint32_t player_net_id, uint8_t tick_rate,
                                        uint32_t sequence_num);
-    std::string createEntityCreate(const Entity &entity, uint32_t sequence_num);
-    std::string createEntityUpdate(const std::vector<Entity> &entities,
-                                   uint32_t sequence_num);
-    std::string createEntityDestroy(const std::vector<uint32_t> &net_ids,
-                                    uint32_t sequence_num);
     std::string createGameState(const std::vector<Entity> &entities,
                                 uint32_t sequence_num);
     std::string createVictory(uint32_t sequence_num);
 
+    // Messages sent every tick are written into a caller-owned buffer whose
+    // capacity is reused, so steady-state broadcasting does not allocate
+    void createEntityCreate(const Entity &entity, uint32_t sequence_num,
+                            std::string &out);
+    // A tick's updates are split in chunk_count messages, numbered by chunk_index
+    void createEntityUpdate(uint32_t snapshot_tick, uint8_t chunk_index,
+                            uint8_t chunk_count, const Entity *entities,
+                            size_t count, uint32_t sequence_num,
+                            std::string &out);
+    void createEntityUpdateCompact(uint32_t snapshot_tick, uint8_t chunk_index,
+                                   uint8_t chunk_count, const Entity *entities,
+                                   size_t count, uint32_t sequence_num,
+                                   std::string &out);
+    void createEntityDestroy(const uint32_t *net_ids, size_t count,
+                             uint32_t sequence_num, std::string &out);
+    void createProjectileSpawn(uint32_t server_tick, uint8_t tick_rate,
+                               const ProjectileSpawn *projectiles, size_t count,
+                               uint32_t sequence_num, std::string &out);
+    void createInputAck(uint32_t snapshot_tick, uint32_t input_sequence,
+                        uint32_t sequence_num, std::string &out);
+    void createEntityDeferred(uint32_t snapshot_tick, const uint32_t *net_ids,
+                              size_t count, uint32_t sequence_num, std::string &out);
+
+    static uint32_t parseSnapshotAck(UdpPayloadView data);
+    static bool parseReliableAck(UdpPayloadView data, uint32_t &delivered,
+                                 uint32_t &received_bits);
+    static uint8_t parseClientCapabilities(UdpPayloadView data);
+    static size_t parseInputState(UdpPayloadView data, InputFrame *frames,
+                                  size_t max_frames);
+
     static uint32_t extractHealth24bit(const uint8_t *data);
     static void packHealth24bit(uint8_t *dest, uint32_t health);
     static float ntohf(uint32_t netfloat);
@@ -59,9 +130,16 @@ class UdpProtocole {
     uint32_t extractSequenceNum(const uint8_t *header);
     std::string createMessage(UdpMessageType type, uint32_t sequence_num,
                               const std::vector<uint8_t> &data);
+    // Writes the header into out, sized for data_size payload bytes
+    uint8_t *beginMessage(std::string &out, UdpMessageType type,
+                          uint32_t sequence_num, size_t data_size);
 
     bool isValidMessageType(uint8_t type);
     bool isValidDataLength(UdpMessageType type, uint32_t length);
+
+    // Scratch buffers of createEntityUpdateCompact, kept between calls
+    std::vector<network::CompactEntity> _compact_entities;
+    network::BitWriter _bit_writer;
 };
 
 #endif /* !UDPPROTOCOLE_HPP_ */
@@ -11,6 +11,7 @@
 #include "ITcpServer.hpp"
 #include <asio.hpp>
 #include <deque>
+#include <iostream>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -34,15 +35,34 @@ class ATcpServer : public ITcpServer {
 
     /**
      * @brief Poll for incoming messages from clients
-     * Thread-safe implementation that retrieves and clears pending messages
+     * Copies pending messages out, prefer drain() on the polling thread
      */
     std::vector<ClientMessage> poll() override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<ClientMessage> out(messages_.begin(), messages_.end());
-        messages_.clear();
+        std::vector<ClientMessage> out;
+        drain([&out](const ClientMessage &msg) { out.push_back(msg); });
         return out;
     }
 
+    /**
+     * @brief Hand every pending message to consume(const ClientMessage&)
+     *
+     * The inbox is swapped out under its lock and consumed without it, must
+     * only be called from the thread that polls.
+     */
+    template <typename Consume>
+    std::size_t drain(Consume &&consume) {
+        {
+            std::lock_guard<std::mutex> lock(inbox_mutex_);
+            draining_.swap(inbox_);
+        }
+        std::size_t count = draining_.size();
+        for (const ClientMessage &msg : draining_) {
+            consume(msg);
+        }
+        draining_.clear();
+        return count;
+    }
+
     /**
      * @brief Get list of all connected clients
      * Thread-safe implementation
@@ -78,11 +98,21 @@ class ATcpServer : public ITcpServer {
     uint32_t generateClientId() { return next_client_id_++; }
 
     /**
-     * @brief Add a message to the message queue (thread-safe)
+     * @brief Append a message to the inbox (thread-safe)
+     *
+     * Unbounded: stream data and disconnect notifications must never be
+     * dropped, a lost one would leave a client stuck in its lobby. Lobby
+     * traffic is light, the lock is only held for the append.
      */
-    void enqueueMessage(const ClientMessage &msg) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        messages_.emplace_back(msg);
+    void enqueueMessage(uint32_t client_id, const std::string &endpoint,
+                        const char *data, std::size_t len,
+                        bool is_disconnect = false) {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        ClientMessage &msg = inbox_.emplace_back();
+        msg.client_id = client_id;
+        msg.client_endpoint = endpoint;
+        msg.message.assign(data, len);
+        msg.is_disconnect = is_disconnect;
     }
 
     /**
@@ -103,12 +133,7 @@ class ATcpServer : public ITcpServer {
         auto it = clients_.find(client_id);
         if (it != clients_.end()) {
             // Create disconnect notification before removing client
-            ClientMessage disconnect_msg;
-            disconnect_msg.client_id = client_id;
-            disconnect_msg.client_endpoint = it->second->endpoint;
-            disconnect_msg.message = "";
-            disconnect_msg.is_disconnect = true;
-            messages_.emplace_back(disconnect_msg);
+            enqueueMessage(client_id, it->second->endpoint, "", 0, true);
 
             it->second->is_connected = false;
             clients_.erase(client_id);
@@ -129,7 +154,9 @@ class ATcpServer : public ITcpServer {
 
     // Protected members accessible to derived classes
     mutable std::mutex mutex_;
-    std::deque<ClientMessage> messages_;
+    std::mutex inbox_mutex_; // Only guards inbox_
+    std::deque<ClientMessage> inbox_;
+    std::deque<ClientMessage> draining_; // Polling thread only
     std::unordered_map<uint32_t, std::shared_ptr<ClientConnection>> clients_;
     uint32_t next_client_id_ = 1;
 };
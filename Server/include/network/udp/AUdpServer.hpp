@@ -9,12 +9,17 @@
 #define AUDPSERVER_HPP_
 
 #include "IUdpServer.hpp"
+#include "network/messages/RingQueue.hpp"
+#include <array>
 #include <asio.hpp>
+#include <atomic>
 #include <chrono>
-#include <deque>
+#include <cstring>
+#include <iostream>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 struct UdpClientInfo {
     uint32_t id;
@@ -24,6 +29,57 @@ struct UdpClientInfo {
     std::chrono::steady_clock::time_point last_activity;
 };
 
+struct UdpEndpointEntry {
+    uint32_t id;
+    asio::ip::udp::endpoint endpoint;
+};
+
+using UdpEndpointSnapshot = std::shared_ptr<const std::vector<UdpEndpointEntry>>;
+
+/**
+ * @brief Packed (address, port) key, IPv4 addresses stored as v4-mapped IPv6
+ */
+struct UdpEndpointKey {
+    std::array<uint8_t, 16> address;
+    uint16_t port;
+
+    bool operator==(const UdpEndpointKey &other) const {
+        return port == other.port && address == other.address;
+    }
+};
+
+struct UdpEndpointKeyHash {
+    std::size_t operator()(const UdpEndpointKey &key) const {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        std::memcpy(&high, key.address.data(), sizeof(high));
+        std::memcpy(&low, key.address.data() + sizeof(high), sizeof(low));
+
+        uint64_t hash = high * 0x9E3779B97F4A7C15ULL;
+        hash ^= low + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+        hash ^= static_cast<uint64_t>(key.port) + 0x9E3779B97F4A7C15ULL +
+                (hash << 6) + (hash >> 2);
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+inline UdpEndpointKey makeEndpointKey(const asio::ip::udp::endpoint &endpoint) {
+    UdpEndpointKey key{};
+    const asio::ip::address address = endpoint.address();
+
+    if (address.is_v4()) {
+        auto bytes = address.to_v4().to_bytes();
+        key.address[10] = 0xFF;
+        key.address[11] = 0xFF;
+        std::memcpy(key.address.data() + 12, bytes.data(), bytes.size());
+    } else {
+        auto bytes = address.to_v6().to_bytes();
+        std::memcpy(key.address.data(), bytes.data(), bytes.size());
+    }
+    key.port = endpoint.port();
+    return key;
+}
+
 /**
  * @brief Abstract base class providing common UDP server functionality
  *
@@ -36,15 +92,30 @@ class AUdpServer : public IUdpServer {
 
     /**
      * @brief Poll for incoming messages from clients
-     * Thread-safe implementation that retrieves and clears pending messages
+     * Copies pending messages out, prefer drain() on the game loop
      */
     std::vector<UdpClientMessage> poll() override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<UdpClientMessage> out(messages_.begin(), messages_.end());
-        messages_.clear();
+        std::vector<UdpClientMessage> out;
+        drain([&out](const UdpClientMessage &msg) { out.push_back(msg); });
         return out;
     }
 
+    /**
+     * @brief Hand every pending message to consume(const UdpClientMessage&)
+     *
+     * Lock-free, must only be called from the thread that polls. Messages
+     * are read in place and their buffers reused by the receive threads.
+     * Datagrams dropped on a full inbox are reported here, at most once per
+     * DROP_REPORT_INTERVAL.
+     */
+    template <typename Consume>
+    std::size_t drain(Consume &&consume) {
+        std::size_t count =
+            inbox_.drain([&consume](UdpClientMessage &msg) { consume(msg); });
+        reportDroppedDatagrams();
+        return count;
+    }
+
     /**
      * @brief Get list of all known clients
      * Thread-safe implementation
@@ -60,6 +131,20 @@ class AUdpServer : public IUdpServer {
         return client_ids;
     }
 
+    /**
+     * @brief Fill out with the active client ids, reusing its capacity
+     *
+     * Reads the endpoint snapshot, so it neither allocates nor holds the
+     * mutex while copying.
+     */
+    void collectConnectedClients(std::vector<uint32_t> &out) const {
+        UdpEndpointSnapshot endpoints = activeEndpoints();
+        out.clear();
+        for (const UdpEndpointEntry &entry : *endpoints) {
+            out.push_back(entry.id);
+        }
+    }
+
     /**
      * @brief Send message to a specific client
      * Must be implemented by derived classes with protocol-specific logic
@@ -67,6 +152,13 @@ class AUdpServer : public IUdpServer {
     bool sendToClient(uint32_t client_id,
                       const std::string &message) override = 0;
 
+    /**
+     * @brief Send the same payload to every active client
+     * Must be implemented by derived classes with protocol-specific logic
+     */
+    bool broadcast(const uint8_t *data, std::size_t size,
+                   uint32_t except_client = 0) override = 0;
+
     /**
      * @brief Remove a client from the known clients list
      * Must be implemented by derived classes with protocol-specific logic
@@ -80,11 +172,38 @@ class AUdpServer : public IUdpServer {
     uint32_t generateClientId() { return next_client_id_++; }
 
     /**
-     * @brief Add a message to the message queue (thread-safe)
+     * @brief Copy a datagram into the next inbox slot, from a receive thread
+     *
+     * Datagrams are dropped when the game loop falls a full inbox behind.
+     * Drops are only counted, a flooding client must not flood the log or
+     * block the receive thread on it too.
      */
-    void enqueueMessage(const UdpClientMessage &msg) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        messages_.emplace_back(msg);
+    bool enqueueMessage(uint32_t client_id, const char *data, std::size_t len) {
+        bool queued = inbox_.tryPush([&](UdpClientMessage &msg) {
+            msg.client_id = client_id;
+            msg.message.assign(data, len);
+        });
+        if (!queued) {
+            dropped_datagrams_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return queued;
+    }
+
+    /**
+     * @brief Log the datagrams dropped since the last report, from the polling thread
+     */
+    void reportDroppedDatagrams() {
+        if (dropped_datagrams_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_drop_report_ < DROP_REPORT_INTERVAL) {
+            return;
+        }
+        last_drop_report_ = now;
+        std::cerr << "[UDPServer] Inbox full, dropped "
+                  << dropped_datagrams_.exchange(0, std::memory_order_relaxed)
+                  << " datagram(s)" << std::endl;
     }
 
     /**
@@ -93,7 +212,13 @@ class AUdpServer : public IUdpServer {
     void registerClient(uint32_t client_id,
                         std::shared_ptr<UdpClientInfo> client) {
         std::lock_guard<std::mutex> lock(mutex_);
+        auto it = clients_.find(client_id);
+        if (it != clients_.end()) {
+            endpoint_index_.erase(makeEndpointKey(it->second->endpoint));
+        }
         clients_[client_id] = client;
+        endpoint_index_[makeEndpointKey(client->endpoint)] = client;
+        rebuildEndpointSnapshot();
     }
 
     /**
@@ -104,10 +229,37 @@ class AUdpServer : public IUdpServer {
         auto it = clients_.find(client_id);
         if (it != clients_.end()) {
             it->second->is_active = false;
+            endpoint_index_.erase(makeEndpointKey(it->second->endpoint));
             clients_.erase(client_id);
+            rebuildEndpointSnapshot();
         }
     }
 
+    /**
+     * @brief Get the current list of active endpoints (thread-safe)
+     *
+     * The list is immutable and only replaced when a client joins or
+     * leaves, so broadcasters can iterate it without holding the mutex.
+     */
+    UdpEndpointSnapshot activeEndpoints() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return endpoints_;
+    }
+
+    /**
+     * @brief Replace the endpoint snapshot, mutex_ must be held
+     */
+    void rebuildEndpointSnapshot() {
+        auto endpoints = std::make_shared<std::vector<UdpEndpointEntry>>();
+        endpoints->reserve(clients_.size());
+        for (const auto &pair : clients_) {
+            if (pair.second->is_active) {
+                endpoints->push_back({pair.first, pair.second->endpoint});
+            }
+        }
+        endpoints_ = std::move(endpoints);
+    }
+
     /**
      * @brief Get a client info safely
      */
@@ -122,16 +274,17 @@ class AUdpServer : public IUdpServer {
 
     /**
      * @brief Find client by endpoint
+     *
+     * Runs for every received datagram, so it is a single hash lookup on
+     * the packed address and port rather than a string comparison.
      */
     std::shared_ptr<UdpClientInfo>
     findClientByEndpoint(const asio::ip::udp::endpoint &endpoint) {
+        UdpEndpointKey key = makeEndpointKey(endpoint);
         std::lock_guard<std::mutex> lock(mutex_);
-        std::string endpoint_str = endpoint.address().to_string() + ":" +
-                                   std::to_string(endpoint.port());
-        for (auto &pair : clients_) {
-            if (pair.second->endpoint_str == endpoint_str) {
-                return pair.second;
-            }
+        auto it = endpoint_index_.find(key);
+        if (it != endpoint_index_.end()) {
+            return it->second;
         }
         return nullptr;
     }
@@ -145,9 +298,20 @@ class AUdpServer : public IUdpServer {
     }
 
     // Protected members accessible to derived classes
+    static constexpr std::size_t INBOX_CAPACITY = 1024;
+    static constexpr std::chrono::seconds DROP_REPORT_INTERVAL{5};
+
     mutable std::mutex mutex_;
-    std::deque<UdpClientMessage> messages_;
+    // Several receive shards may feed one session, the game loop drains
+    MpscRing<UdpClientMessage> inbox_{INBOX_CAPACITY};
+    std::atomic<uint64_t> dropped_datagrams_{0};
+    std::chrono::steady_clock::time_point last_drop_report_{}; // Polling thread only
     std::unordered_map<uint32_t, std::shared_ptr<UdpClientInfo>> clients_;
+    std::unordered_map<UdpEndpointKey, std::shared_ptr<UdpClientInfo>,
+                       UdpEndpointKeyHash>
+        endpoint_index_;
+    UdpEndpointSnapshot endpoints_ =
+        std::make_shared<const std::vector<UdpEndpointEntry>>();
     uint32_t next_client_id_ = 1;
 };
 
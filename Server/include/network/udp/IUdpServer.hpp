@@ -8,12 +8,13 @@
 #ifndef IUDPSERVER_HPP_
 #define IUDPSERVER_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+// Senders are known by client_id, their endpoint stays in the server
 struct UdpClientMessage {
-    std::string client_endpoint;
     std::string message;
     uint32_t client_id;
 };
@@ -44,6 +45,16 @@ class IUdpServer {
     virtual bool sendToClient(uint32_t client_id,
                               const std::string &message) = 0;
 
+    /**
+     * @brief Send the same payload to every active client
+     * @param data Payload bytes, read once for all recipients
+     * @param size Payload length in bytes
+     * @param except_client Client ID to skip, 0 for none
+     * @return true if every send succeeded, false otherwise
+     */
+    virtual bool broadcast(const uint8_t *data, std::size_t size,
+                           uint32_t except_client = 0) = 0;
+
     /**
      * @brief Remove a client from the known clients list
      * @param client_id The unique identifier of the client to remove
@@ -9,33 +9,152 @@
 #define UDPSERVER_HPP_
 
 #include "AUdpServer.hpp"
+#include <array>
 #include <asio.hpp>
 #include <chrono>
 #include <cstdint>
+#include <memory>
+#include <shared_mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+/**
+ * @brief UDP endpoint of one game, or a port shared by many games
+ *
+ * A standalone server owns its socket and receive thread. A shared port
+ * (openSharedPort) owns the socket too but no clients: each datagram starts
+ * with an 8-byte SESSION_TOKEN that selects the session it is handed to,
+ * unknown tokens are dropped. A session is the server of one game on a
+ * shared port, it sends through the shared socket and has no thread.
+ * Sessions on different game threads send concurrently, each with its own
+ * buffers; the socket calls themselves go straight to the kernel.
+ *
+ * A shared port may be split into receive shards: sockets bound to the
+ * same port with SO_REUSEPORT, each drained by its own thread pinned to a
+ * core. The kernel hashes each client's address to one shard, which hands
+ * the datagram straight to the session's inbox.
+ */
 class UDPServer : public AUdpServer {
   public:
     UDPServer(uint16_t port, uint32_t max_clients = 4);
+
+    /** @brief Creates a session of a shared port, with a fresh random token */
+    UDPServer(UDPServer &shared_port, uint32_t max_clients);
+
     ~UDPServer();
 
+    /** @brief Opens a port whose datagrams are routed to sessions by token
+     * @param shards Receive sockets and threads, more than 1 needs SO_REUSEPORT */
+    static std::unique_ptr<UDPServer> openSharedPort(uint16_t port,
+                                                     std::size_t shards = 1);
+
+    /** @brief Token clients put in front of their datagrams, 0 if not a session */
+    uint64_t getSessionToken() const { return session_token_; }
+
     bool sendToClient(uint32_t client_id, const std::string &message) override;
+    bool broadcast(const uint8_t *data, std::size_t size,
+                   uint32_t except_client = 0) override;
     void disconnectClient(uint32_t client_id) override;
 
+    /**
+     * @brief Queue a datagram for the next flush() instead of sending it now
+     *
+     * Must be called from the same thread as flush().
+     */
+    bool queueToClient(uint32_t client_id, const std::string &message);
+
+    /**
+     * @brief Send every queued datagram
+     *
+     * On Linux the queue goes out with as few sendmmsg calls as possible;
+     * elsewhere, or if sendmmsg fails, each datagram is sent on its own.
+     */
+    void flush();
+
     uint32_t getMaxClients() const { return max_clients_; }
+    void setMaxClients(uint32_t max_clients) {
+        std::lock_guard<std::mutex> lock(accept_mutex_);
+        max_clients_ = max_clients;
+    }
     uint32_t getCurrentClientCount() const;
     void checkAndDisconnectInactiveClients(std::chrono::seconds timeout);
 
   private:
+    struct PendingDatagram {
+        asio::ip::udp::endpoint endpoint;
+        std::string data;
+    };
+
+    static constexpr std::size_t SESSION_TOKEN_SIZE = 8;
+
+    /** @brief Sessions of a shared port, looked up by every receive shard */
+    struct SessionTable {
+        std::shared_mutex mutex; ///< Shared by receive threads, unique to open/close
+        std::unordered_map<uint64_t, UDPServer *> sessions;
+    };
+
+    /** @brief Receive socket of a shared port */
+    UDPServer(uint16_t port, std::shared_ptr<SessionTable> sessions, bool reuse_port);
+
+    void startReceiving();
     void start_receive();
+    void handleDatagram(const char *data, std::size_t len,
+                        const asio::ip::udp::endpoint &from);
+    void acceptClient(const char *data, std::size_t len,
+                      const asio::ip::udp::endpoint &from);
+    void routeDatagram(const char *data, std::size_t len,
+                       const asio::ip::udp::endpoint &from);
     bool canAcceptNewClient() const;
 
-    asio::io_context ctx_;
-    asio::ip::udp::socket socket_;
+    uint64_t openSession(UDPServer &session);
+    void closeSession(uint64_t token);
+
+    // Null for a session, which uses the shared port's socket
+    std::unique_ptr<asio::io_context> ctx_;
+    std::unique_ptr<asio::ip::udp::socket> own_socket_;
+    asio::ip::udp::socket *socket_;
     asio::ip::udp::endpoint remote_endpoint_;
+    std::array<char, 1500> recv_buffer_;  ///< Only one receive is ever pending
     std::thread thread_;
     uint32_t max_clients_;
+
+    // Shared port and its shards: sessions by token, null otherwise
+    std::shared_ptr<SessionTable> sessions_;
+    std::vector<std::unique_ptr<UDPServer>> shards_; // Other receive sockets
+    std::mutex accept_mutex_; // Shards may admit clients to one session at once
+
+    // Session: the shared port it belongs to
+    UDPServer *shared_port_ = nullptr;
+    uint64_t session_token_ = 0;
+
+    std::vector<PendingDatagram> pending_;  ///< Reused across flushes
+    std::size_t pending_count_ = 0;
+
+#ifdef __linux__
+    static constexpr std::size_t RECV_BATCH_SIZE = 32;
+    static constexpr std::size_t RECV_BUFFER_SIZE = 1500;
+
+    void start_receive_batch();
+    bool drainReceiveBatch();
+    std::size_t sendBatch(mmsghdr *msgs, std::size_t count);
+
+    // Preallocated ring recvmmsg fills in place, one slot per datagram
+    std::vector<std::array<char, RECV_BUFFER_SIZE>> recv_buffers_;
+    std::vector<sockaddr_storage> recv_addrs_;
+    std::vector<iovec> recv_iovs_;
+    std::vector<mmsghdr> recv_msgs_;
+
+    std::vector<iovec> send_iovs_;
+    std::vector<mmsghdr> send_msgs_;
+    std::vector<mmsghdr> broadcast_msgs_;
+#endif
 };
 
 #endif /* !UDPSERVER_HPP_ */
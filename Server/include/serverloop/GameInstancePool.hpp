@@ -0,0 +1,92 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** GameInstancePool.hpp
+*/
+
+#ifndef GAMEINSTANCEPOOL_HPP_
+#define GAMEINSTANCEPOOL_HPP_
+
+#include "serverloop/GameServerLoop.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs many hosted games on a fixed set of worker threads
+ *
+ * Each worker keeps its games in a heap ordered by next tick deadline and
+ * ticks whichever is due first. A worker with nothing due steals a due game
+ * from another worker, which then stays with the thief. A game is only ever
+ * ticked by the worker that took it out of a heap, so GameServerLoop needs
+ * no locking of its own.
+ */
+class GameInstancePool {
+  public:
+    /** @brief Starts the workers
+     * @param worker_count Number of simulation threads, at least 1 */
+    explicit GameInstancePool(std::size_t worker_count);
+    ~GameInstancePool();
+
+    GameInstancePool(const GameInstancePool &) = delete;
+    GameInstancePool &operator=(const GameInstancePool &) = delete;
+
+    /** @brief Hands over a game opened with startHosted(), ticked until it ends
+     * @param instance_id Reported by collectFinished() once the game is over */
+    void add(uint16_t instance_id, std::unique_ptr<GameServerLoop> game);
+
+    /** @brief Appends the ids of the games that ended since the last call */
+    void collectFinished(std::vector<uint16_t> &out);
+
+    /** @brief Stops the workers and closes every game still running */
+    void stop();
+
+    /** @brief Number of games currently hosted */
+    std::size_t size() const { return _hosted; }
+
+    std::size_t workerCount() const { return _workers.size(); }
+
+  private:
+    using clock = TickScheduler::clock;
+
+    struct Slot {
+        clock::time_point deadline;
+        uint16_t instance_id;
+        std::unique_ptr<GameServerLoop> game;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::vector<Slot> heap; // Earliest deadline first
+        std::thread thread;
+    };
+
+    void workerLoop(std::size_t index);
+
+    /** @brief Pops a due game from the worker's heap, or steals one */
+    bool takeDue(std::size_t index, clock::time_point now, Slot &out);
+
+    /** @brief Pops the top of a locked heap if it is due */
+    static bool popDue(Worker &worker, clock::time_point now, Slot &out);
+
+    void push(Worker &worker, Slot slot);
+
+    // Longest an idle worker waits before looking for games to steal
+    static constexpr std::chrono::milliseconds IDLE_WAIT{1};
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<bool> _running;
+    std::atomic<std::size_t> _hosted;
+    std::atomic<std::size_t> _next_worker; // Round robin for add()
+
+    std::mutex _finished_mutex;
+    std::vector<uint16_t> _finished;
+};
+
+#endif /* !GAMEINSTANCEPOOL_HPP_ */
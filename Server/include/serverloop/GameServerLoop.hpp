@@ -9,36 +9,84 @@
 #define GAMESERVERLOOP_HPP_
 
 #include "gamelogic/GameLogic.hpp"
+#include "network/protocol/FrameBuilder.hpp"
+#include "network/protocol/ReliableChannel.hpp"
 #include "network/protocol/UdpProtocole.hpp"
 #include "network/udp/UdpServer.hpp"
+#include "serverloop/RelevancyFilter.hpp"
+#include "serverloop/TickScheduler.hpp"
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdint>
 #include <memory>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 class GameServerLoop {
   public:
-    GameServerLoop(uint16_t port = 4242, uint32_t max_clients = 4, uint8_t level_id = 1);
+    GameServerLoop(uint16_t port = 4242, uint32_t max_clients = 4, uint8_t level_id = 1,
+                   uint32_t tick_rate = 60, uint32_t broadcast_rate = 60);
     ~GameServerLoop();
 
+    /** @brief Runs the game on its own thread, as the only game of the process */
     void start();
     void stop();
     bool isRunning() const { return _running; }
 
+    /** @brief Opens the game without a thread, for a GameInstancePool to step
+     * @param shared_port Port opened with UDPServer::openSharedPort to join as
+     *        a session, nullptr to bind the game's own port
+     * @return True if the UDP socket could be bound */
+    bool startHosted(UDPServer *shared_port = nullptr);
+
+    /** @brief Gives a hosted game kept warm its lobby, before its first tick
+     *
+     * The socket or session and the GameLogic already exist, only the
+     * player count and level change, and the join timeout starts now. */
+    void assign(uint32_t max_clients, uint8_t level_id);
+
+    /** @brief Token clients must send on the shared port, 0 on an own port */
+    uint64_t getSessionToken() const {
+        return _udp_server ? _udp_server->getSessionToken() : 0;
+    }
+
+    /** @brief Runs one tick of a hosted game, once nextTickDeadline() passed
+     * @return False once the game is over */
+    bool tick();
+
+    /** @brief Time the next tick is due */
+    TickScheduler::clock::time_point nextTickDeadline() const {
+        return _scheduler.nextDeadline();
+    }
+
     static void signalHandler(int signal);
     static GameServerLoop *instance;
     void broadcastEntityUpdates();
 
   private:
     void run();
+    void open();
+    void step();
     void processMessages();
+    void handleMessage(const UdpClientMessage &msg);
     void setupSignalHandlers();
+    bool clientHasCapability(uint32_t client_id, uint8_t capability) const;
+    bool simulatesProjectiles(uint32_t client_id) const;
+    void buildProjectileSpawns(const std::vector<GameLogic::NewEntityInfo> &projectiles);
+    void appendEntityUpdates(FrameBuilder &frame, uint32_t tick, bool compact);
+    void sendFrame(uint32_t client_id, const FrameBuilder &frame);
+    ReliableChannel *reliableChannel(uint32_t client_id);
+    void appendEvent(uint32_t client_id, FrameBuilder &frame, const std::string &message);
+    void queueEvent(uint32_t client_id, const std::string &message);
+    void broadcastEvent(const std::string &message, uint32_t except_client = 0);
 
     uint16_t _port;
     uint32_t _max_clients;
     uint8_t _level_id;
+    uint32_t _tick_rate;
+    uint32_t _broadcast_interval; // Simulation ticks between two broadcasts
     bool _in_game;
     bool _victory_sent;
     std::chrono::time_point<std::chrono::steady_clock> _last_tick;
@@ -47,7 +95,35 @@ class GameServerLoop {
     std::unique_ptr<UDPServer> _udp_server;
     std::unique_ptr<std::thread> _loop_thread;
     std::unique_ptr<GameLogic> _game_logic;
+    TickScheduler _scheduler;
     UdpProtocole _protocol;
+
+    // Delta compression: last snapshot tick acked by each client
+    std::unordered_map<uint32_t, uint32_t> _acked_ticks;
+    // CLIENT_PING capability bits of each client (network::ClientCapability)
+    std::unordered_map<uint32_t, uint8_t> _client_caps;
+    // Newest INPUT_STATE sequence applied for each client
+    std::unordered_map<uint32_t, uint32_t> _input_sequences;
+    RelevancyFilter _relevancy;
+    // Create, destroy and victory events of CAP_RELIABLE_EVENTS clients
+    std::unordered_map<uint32_t, ReliableChannel> _reliable;
+    uint32_t _reliable_resend_ticks; // Ticks without an ack before an event is resent
+    // Per-tick scratch buffers, cleared but never freed so that steady-state
+    // broadcasting does not allocate
+    std::vector<uint32_t> _clients;
+    std::vector<EntityState> _delta_states;
+    std::vector<EntityState> _relevant_states;
+    std::vector<uint32_t> _deferred;
+    std::vector<Entity> _update_entities;
+    std::vector<GameLogic::NewEntityInfo> _new_entities;
+    std::vector<uint> _destroyed;
+    std::vector<GameLogic::NewEntityInfo> _new_projectiles;
+    std::vector<ProjectileSpawn> _projectile_spawns;
+    std::vector<std::string> _spawn_messages; // First _spawn_message_count are current
+    size_t _spawn_message_count = 0;
+    std::string _message; // Serialized message, copied into frames
+    // Outgoing datagrams of the current tick, per client
+    std::unordered_map<uint32_t, FrameBuilder> _frames;
 };
 
 #endif /* !GAMESERVERLOOP_HPP_ */
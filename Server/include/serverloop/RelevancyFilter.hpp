@@ -0,0 +1,110 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** RelevancyFilter.hpp
+*/
+
+#ifndef RELEVANCYFILTER_HPP_
+#define RELEVANCYFILTER_HPP_
+
+#include "gamelogic/GameLogic.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Picks which changed entities each client gets in a broadcast
+ *
+ * Every (client, entity) pair has a priority accumulator. Each broadcast
+ * adds the entity's weight to it: 1 for players, bosses, power-ups and
+ * threats near the client's player, less for distant enemies and bullets.
+ * An entity is sent once its accumulator reaches 1, highest first, while
+ * it fits the client's byte budget. Its accumulator then drops back to 0.
+ *
+ * A held back entity keeps the fields it did not send as pending and
+ * resends them until the client acks a snapshot that carried them. The
+ * client only acks a tick once all of its update chunks arrived and treats
+ * it as a complete baseline, so without this a change skipped in that tick
+ * would be lost.
+ *
+ * Entities held back with a pending position are also listed, so the
+ * client can tell them from entities that did not move.
+ *
+ * The budget follows the client's ack lag: halved when acks fall behind,
+ * grown back slowly while they keep up.
+ */
+class RelevancyFilter {
+  public:
+    /** @brief Creates a filter
+     * @param tick_rate Server ticks per second, scales the ack lag limit */
+    explicit RelevancyFilter(uint32_t tick_rate = 60);
+
+    /** @brief Chooses the entity updates sent to a client this broadcast
+     * @param client_id Receiving client
+     * @param tick Tick of the snapshot being sent
+     * @param acked_tick Last snapshot tick the client acked (0 = none)
+     * @param viewer Position of the client's player, nullptr if it has none
+     * @param delta Entities changed since acked_tick, sorted by net_id
+     * @param current Every entity of the snapshot being sent, sorted by net_id
+     * @param compact True if the client gets ENTITY_UPDATE_COMPACT
+     * @param out Filled with the states to send, sorted by net_id
+     * @param deferred Filled with the net_ids held back with a changed
+     *                 position, sorted */
+    void select(uint32_t client_id, uint32_t tick, uint32_t acked_tick,
+                const Position *viewer, const std::vector<EntityState> &delta,
+                const std::vector<EntityState> &current, bool compact,
+                std::vector<EntityState> &out, std::vector<uint32_t> &deferred);
+
+    /** @brief Drops the state kept for a client that left */
+    void removeClient(uint32_t client_id);
+
+  private:
+    struct EntityRelevancy {
+        float priority = 0.0f; ///< Accumulated weight since last sent
+        uint8_t pending = 0;   ///< network::EntityField bits not yet acked
+        uint32_t sent_tick = 0; ///< Tick pending was last sent in, 0 if not since
+        uint32_t seen_tick = 0; ///< Last broadcast it was a candidate in
+    };
+
+    struct ClientRelevancy {
+        size_t budget = DEFAULT_BUDGET;
+        uint32_t last_cut_tick = 0;
+        std::unordered_map<uint32_t, EntityRelevancy> entities;
+    };
+
+    struct Candidate {
+        const EntityState *state;
+        uint8_t fields;
+        float priority;
+    };
+
+    /** @brief Updates the client budget from its ack lag */
+    void adaptBudget(ClientRelevancy &client, uint32_t tick, uint32_t acked_tick) const;
+
+    /** @brief Adds a candidate, or defers it if its priority is still below 1 */
+    void consider(ClientRelevancy &client, uint32_t tick, const Position *viewer,
+                  const EntityState &state, uint8_t fields);
+
+    /** @brief Weight added to an entity's priority each broadcast */
+    static float weight(const EntityState &state, const Position *viewer);
+
+    /** @brief Upper bound of the bytes an entity record takes */
+    static size_t encodedSize(const EntityState &state, uint8_t fields, bool compact);
+
+    // Entity payload per broadcast, headers excluded
+    static constexpr size_t DEFAULT_BUDGET = 4800; // 4 full datagrams
+    static constexpr size_t MIN_BUDGET = 600;
+    static constexpr size_t MAX_BUDGET = 9600;
+    static constexpr size_t BUDGET_STEP = 120;
+
+    // Normalized distance under which enemies and their shots are threats
+    static constexpr float NEAR_RADIUS = 0.35f;
+
+    uint32_t _lag_limit; // Ticks behind before the budget is cut
+    std::unordered_map<uint32_t, ClientRelevancy> _clients;
+    std::vector<Candidate> _candidates;
+};
+
+#endif /* !RELEVANCYFILTER_HPP_ */
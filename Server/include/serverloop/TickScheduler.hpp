@@ -0,0 +1,78 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** TickScheduler.hpp
+*/
+
+#ifndef TICKSCHEDULER_HPP_
+#define TICKSCHEDULER_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Paces the server loop at a fixed tick rate
+ *
+ * Each tick has an absolute steady_clock deadline. The scheduler sleeps
+ * until shortly before it and spins the rest of the way, so the tick rate
+ * does not drift with the OS sleep granularity. A late tick is reported as
+ * an overrun; when the loop falls too far behind, the schedule is reset
+ * instead of running a burst of catch-up ticks.
+ */
+class TickScheduler {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /** @brief Creates a scheduler
+     * @param tick_rate Ticks per second (30, 60 or 120) */
+    explicit TickScheduler(uint32_t tick_rate = 60);
+
+    /** @brief Restarts the schedule, next tick is one period from now */
+    void reset();
+
+    /** @brief Blocks until the next tick deadline */
+    void waitForNextTick();
+
+    /** @brief Accounts for a tick started at now by a caller that waited itself
+     * @param now Time the tick started, at or after nextDeadline() */
+    void tickStarted(clock::time_point now);
+
+    /** @brief Deadline of the next tick */
+    clock::time_point nextDeadline() const { return _deadline; }
+
+    /** @brief Ticks per second */
+    uint32_t getTickRate() const { return _tick_rate; }
+
+    /** @brief Duration of one tick in seconds */
+    float getTickDuration() const { return 1.0f / static_cast<float>(_tick_rate); }
+
+    /** @brief Number of ticks started after their deadline */
+    uint64_t getOverrunCount() const { return _total_overruns; }
+
+    /** @brief Returns true if the rate is one of the supported ones */
+    static bool isSupportedRate(uint32_t tick_rate);
+
+  private:
+    /** @brief Counts a late tick and moves the deadline on */
+    void recordOverrun(clock::time_point now);
+
+    /** @brief Prints the overruns of the last report period, if any */
+    void reportOverruns(clock::time_point now);
+
+    static constexpr std::chrono::microseconds SPIN_MARGIN{1500};
+    static constexpr uint32_t MAX_LATE_TICKS = 3;
+    static constexpr std::chrono::seconds REPORT_INTERVAL{5};
+
+    uint32_t _tick_rate;
+    clock::duration _period;
+    clock::time_point _deadline;
+    clock::time_point _last_report;
+
+    uint64_t _total_overruns;
+    uint32_t _overruns;
+    uint32_t _resyncs;
+    clock::duration _worst_overrun;
+};
+
+#endif /* !TICKSCHEDULER_HPP_ */
@@ -7,6 +7,7 @@
 
 #include "core/StartServer.hpp"
 #include "serverloop/GameServerLoop.hpp"
+#include <algorithm>
 #include <arpa/inet.h>
 #include <iostream>
 #include <sys/wait.h>
@@ -14,8 +15,12 @@
 
 StartServer *StartServer::_instance = nullptr;
 
-StartServer::StartServer(int port, int base_udp_port)
-    : _tcp_port(port), _base_udp_port(base_udp_port), _next_server_id(1),
+StartServer::StartServer(int port, int base_udp_port, uint32_t tick_rate,
+                         uint32_t broadcast_rate, uint32_t game_workers,
+                         uint32_t udp_shards, uint32_t warm_instances)
+    : _tcp_port(port), _base_udp_port(base_udp_port), _tick_rate(tick_rate),
+      _broadcast_rate(broadcast_rate), _next_server_id(1),
+      _warm_target(game_workers > 0 ? warm_instances : 0),
       _protocol(), _game_session() {
 
     _instance = this;
@@ -31,6 +36,28 @@ StartServer::StartServer(int port, int base_udp_port)
         std::cerr << "Failed to start TCP server: " << e.what() << std::endl;
         throw;
     }
+
+    if (game_workers > 0) {
+        try {
+            _shared_port = UDPServer::openSharedPort(static_cast<uint16_t>(base_udp_port),
+                                                     udp_shards);
+        } catch (const std::exception &e) {
+            std::cerr << "Failed to open shared UDP port: " << e.what() << std::endl;
+            throw;
+        }
+        _instance_pool = std::make_unique<GameInstancePool>(game_workers);
+        std::cout << "Game instances run in process on " << game_workers
+                  << " worker thread(s), sharing UDP port " << base_udp_port
+                  << " across " << std::max<uint32_t>(1, udp_shards)
+                  << " receive thread(s)" << std::endl;
+
+        if (_warm_target > 0) {
+            _warm_instances.reserve(_warm_target + 1);
+            _warm_builder = std::thread(&StartServer::warmBuilderLoop, this);
+            std::cout << "Keeping " << _warm_target << " game instance(s) warm"
+                      << std::endl;
+        }
+    }
 }
 
 StartServer::~StartServer() {
@@ -45,6 +72,11 @@ StartServer::~StartServer() {
             kill(instance.process_id, SIGTERM);
         }
     }
+    // Games are sessions of the shared port, close them first
+    stopWarmBuilder();
+    _warm_instances.clear();
+    _instance_pool.reset();
+    _shared_port.reset();
 
     _tcp_server.reset();
     _instance = nullptr;
@@ -83,13 +115,8 @@ void StartServer::lobbyLoop() {
 
     while (_running) {
         // Poll for messages
-        auto messages = _tcp_server->poll();
-
-        if (!messages.empty()) {
-            for (const auto &message : messages) {
-                processMessage(message);
-            }
-        }
+        _tcp_server->drain(
+            [this](const ClientMessage &message) { processMessage(message); });
 
         // Cleanup finished games
         cleanupFinishedGames();
@@ -416,21 +443,48 @@ bool StartServer::startGameInstance(uint16_t lobby_id) {
         return false;
     }
 
-    // Allocate UDP port
-    uint16_t udp_port = allocateUdpPort();
+    // Pool games all share the base port, forked ones each get their own
+    uint16_t udp_port = _shared_port ? static_cast<uint16_t>(_base_udp_port)
+                                     : allocateUdpPort();
     if (udp_port == 0) {
         std::cerr << "Cannot start game: no UDP ports available" << std::endl;
         return false;
     }
 
+    // A pool game opens its session before the lobby is marked started, a
+    // failure leaves the lobby waiting for the players to ready up again
+    std::unique_ptr<GameServerLoop> game;
+    if (_instance_pool) {
+        game = takeGameInstance();
+        if (!game) {
+            std::cerr << "Cannot start game: failed to open its session"
+                      << std::endl;
+            broadcastToLobby(lobby_id,
+                             _protocol.createError(ProtocolError::INTERNAL_SERVER_ERROR));
+            return false;
+        }
+    }
+
     // Mark game as started
     if (!_game_session.startGame(lobby_id)) {
-        freeUdpPort(udp_port);
+        if (game) {
+            std::lock_guard<std::mutex> lock(_warm_mutex);
+            _warm_instances.push_back(std::move(game)); // Still unassigned
+        } else {
+            freeUdpPort(udp_port);
+        }
         std::cerr << "Cannot start game: failed to mark as started"
                   << std::endl;
         return false;
     }
 
+    uint64_t session_token = 0;
+    if (game) {
+        game->assign(lobby->players.size(), lobby->level_id);
+        session_token = game->getSessionToken();
+        _instance_pool->add(lobby_id, std::move(game));
+    }
+
     uint16_t server_id = _next_server_id++;
     uint32_t server_ip = getServerIp();
 
@@ -443,9 +497,20 @@ bool StartServer::startGameInstance(uint16_t lobby_id) {
 
     // Send GAME_START to all players (including level_id)
     std::string game_start_msg =
-        _protocol.createGameStart(udp_port, server_id, server_ip, lobby->level_id);
+        _protocol.createGameStart(udp_port, server_id, server_ip, lobby->level_id,
+                                  session_token);
     broadcastToLobby(lobby_id, game_start_msg);
 
+    if (_instance_pool) {
+        GameInstance instance(lobby_id, server_id, 0, udp_port, server_ip);
+        instance.session_token = session_token;
+        for (const auto &player : lobby->players) {
+            instance.player_ids.push_back(player.client_id);
+        }
+        _game_instances[lobby_id] = instance;
+        return true;
+    }
+
     // Fork process for game instance
     pid_t pid = fork();
 
@@ -461,7 +526,8 @@ bool StartServer::startGameInstance(uint16_t lobby_id) {
                   << "] Started in child process (level=" << static_cast<int>(lobby->level_id) << ")" << std::endl;
 
         try {
-            GameServerLoop game_loop(udp_port, lobby->players.size(), lobby->level_id);
+            GameServerLoop game_loop(udp_port, lobby->players.size(), lobby->level_id,
+                                     _tick_rate, _broadcast_rate);
             game_loop.start();
 
             while (game_loop.isRunning()) {
@@ -497,6 +563,61 @@ bool StartServer::startGameInstance(uint16_t lobby_id) {
     return false;
 }
 
+std::unique_ptr<GameServerLoop> StartServer::takeGameInstance() {
+    {
+        std::lock_guard<std::mutex> lock(_warm_mutex);
+        if (!_warm_instances.empty()) {
+            auto game = std::move(_warm_instances.back());
+            _warm_instances.pop_back();
+            _warm_cv.notify_one();
+            return game;
+        }
+    }
+    return openGameInstance();
+}
+
+std::unique_ptr<GameServerLoop> StartServer::openGameInstance() {
+    auto game = std::make_unique<GameServerLoop>(_base_udp_port, MAX_PLAYERS, 1,
+                                                 _tick_rate, _broadcast_rate);
+    if (!game->startHosted(_shared_port.get())) {
+        return nullptr;
+    }
+    return game;
+}
+
+void StartServer::warmBuilderLoop() {
+    std::unique_lock<std::mutex> lock(_warm_mutex);
+    while (!_warm_stopping) {
+        if (_warm_instances.size() >= _warm_target) {
+            _warm_cv.wait(lock);
+            continue;
+        }
+
+        // Loading a game takes a while, lobbies may take games meanwhile
+        lock.unlock();
+        auto game = openGameInstance();
+        lock.lock();
+
+        if (!game) {
+            std::cerr << "[Lobby Server] Failed to open a warm game instance" << std::endl;
+            _warm_cv.wait_for(lock, std::chrono::seconds(1));
+            continue;
+        }
+        _warm_instances.push_back(std::move(game));
+    }
+}
+
+void StartServer::stopWarmBuilder() {
+    {
+        std::lock_guard<std::mutex> lock(_warm_mutex);
+        _warm_stopping = true;
+    }
+    _warm_cv.notify_all();
+    if (_warm_builder.joinable()) {
+        _warm_builder.join();
+    }
+}
+
 uint16_t StartServer::allocateUdpPort() {
     uint16_t port = _base_udp_port;
 
@@ -519,7 +640,15 @@ void StartServer::freeUdpPort(uint16_t port) {
 void StartServer::cleanupFinishedGames() {
     std::vector<uint16_t> finished_lobbies;
 
+    if (_instance_pool) {
+        _instance_pool->collectFinished(finished_lobbies);
+    }
+
     for (const auto &[lobby_id, instance] : _game_instances) {
+        if (instance.process_id == 0) {
+            continue; // Pool game, reported above
+        }
+
         // Check if process is still running
         int status;
         pid_t result = waitpid(instance.process_id, &status, WNOHANG);
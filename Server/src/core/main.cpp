@@ -6,6 +6,7 @@
 */
 
 #include "core/StartServer.hpp"
+#include "serverloop/TickScheduler.hpp"
 #include <cstring>
 #include <iostream>
 #include <map>
@@ -14,12 +15,19 @@
 struct ServerConfig {
     int tcp_port;
     int base_udp_port;
+    uint32_t tick_rate;
+    uint32_t broadcast_rate;
+    uint32_t game_workers;
+    uint32_t udp_shards;
+    uint32_t warm_instances;
     bool valid;
 };
 
 static void show_helper() {
     std::cout << "USAGE:" << std::endl;
-    std::cout << "./r-type_server [-p <tcp_port>] [-u <base_udp_port>]"
+    std::cout << "./r-type_server [-p <tcp_port>] [-u <base_udp_port>] "
+                 "[-t <tick_rate>] [-b <broadcast_rate>] [-w <workers>] "
+                 "[-s <shards>] [-i <instances>]"
               << std::endl;
     std::cout << "\nDESCRIPTION:" << std::endl;
     std::cout << "  Starts a lobby server that manages multiple game instances."
@@ -33,6 +41,21 @@ static void show_helper() {
     std::cout
         << "  -u <port>    Base UDP port number for game instances (1024-65535)"
         << std::endl;
+    std::cout << "  -t <rate>    Simulation tick rate in Hz: 30, 60 or 120 "
+                 "(default 60)"
+              << std::endl;
+    std::cout << "  -b <rate>    Entity update send rate in Hz, a divisor of "
+                 "the tick rate (default: tick rate)"
+              << std::endl;
+    std::cout << "  -w <count>   Run games as threads of one process on <count> "
+                 "workers instead of one process per game"
+              << std::endl;
+    std::cout << "  -s <count>   With -w, receive the shared UDP port on <count> "
+                 "SO_REUSEPORT sockets, one pinned thread each (default 1)"
+              << std::endl;
+    std::cout << "  -i <count>   With -w, keep <count> games open ahead of time "
+                 "so matches start at once (default 2)"
+              << std::endl;
     std::cout << "  -h           Show this help message" << std::endl;
     std::cout << "\nEXAMPLE:" << std::endl;
     std::cout << "  ./r-type_server -p 8000 -u 8080" << std::endl;
@@ -56,8 +79,33 @@ static bool is_a_valid_port(const char *str) {
     return port >= 1024 && port <= 65535;
 }
 
+static bool is_a_valid_rate(const char *str) {
+    if (str == nullptr || *str == '\0')
+        return false;
+
+    for (int i = 0; str[i]; ++i) {
+        if (!std::isdigit(str[i]))
+            return false;
+    }
+
+    int rate = std::atoi(str);
+    return rate >= 1 && rate <= 1000;
+}
+
+static bool is_a_valid_count(const char *str, int max) {
+    if (str == nullptr || *str == '\0')
+        return false;
+
+    for (int i = 0; str[i]; ++i) {
+        if (!std::isdigit(str[i]))
+            return false;
+    }
+
+    return std::atoi(str) <= max;
+}
+
 static ServerConfig parse_arguments(int ac, char **av) {
-    ServerConfig config = {0, 0, false};
+    ServerConfig config = {0, 0, 60, 0, 0, 1, 2, false};
 
     if (ac == 1 || (ac == 2 && std::strcmp("-h", av[1]) == 0)) {
         show_helper();
@@ -86,6 +134,56 @@ static ServerConfig parse_arguments(int ac, char **av) {
             }
             ports["-u"] = std::atoi(av[i + 1]);
             i++;
+        } else if (std::strcmp(av[i], "-t") == 0) {
+            if (i + 1 >= ac || !is_a_valid_rate(av[i + 1]) ||
+                !TickScheduler::isSupportedRate(
+                    static_cast<uint32_t>(std::atoi(av[i + 1])))) {
+                std::cerr << "Error: Tick rate after -t must be 30, 60 or 120"
+                          << std::endl;
+                show_helper();
+                return config;
+            }
+            config.tick_rate = static_cast<uint32_t>(std::atoi(av[i + 1]));
+            i++;
+        } else if (std::strcmp(av[i], "-b") == 0) {
+            if (i + 1 >= ac || !is_a_valid_rate(av[i + 1])) {
+                std::cerr << "Error: Invalid or missing rate after -b flag"
+                          << std::endl;
+                show_helper();
+                return config;
+            }
+            config.broadcast_rate =
+                static_cast<uint32_t>(std::atoi(av[i + 1]));
+            i++;
+        } else if (std::strcmp(av[i], "-w") == 0) {
+            if (i + 1 >= ac || !is_a_valid_rate(av[i + 1]) ||
+                std::atoi(av[i + 1]) > 256) {
+                std::cerr << "Error: Worker count after -w must be 1 to 256"
+                          << std::endl;
+                show_helper();
+                return config;
+            }
+            config.game_workers = static_cast<uint32_t>(std::atoi(av[i + 1]));
+            i++;
+        } else if (std::strcmp(av[i], "-s") == 0) {
+            if (i + 1 >= ac || !is_a_valid_rate(av[i + 1]) ||
+                std::atoi(av[i + 1]) > 64) {
+                std::cerr << "Error: Shard count after -s must be 1 to 64"
+                          << std::endl;
+                show_helper();
+                return config;
+            }
+            config.udp_shards = static_cast<uint32_t>(std::atoi(av[i + 1]));
+            i++;
+        } else if (std::strcmp(av[i], "-i") == 0) {
+            if (i + 1 >= ac || !is_a_valid_count(av[i + 1], 64)) {
+                std::cerr << "Error: Warm instance count after -i must be 0 to 64"
+                          << std::endl;
+                show_helper();
+                return config;
+            }
+            config.warm_instances = static_cast<uint32_t>(std::atoi(av[i + 1]));
+            i++;
         } else if (std::strcmp(av[i], "-h") == 0) {
             show_helper();
             return config;
@@ -104,6 +202,21 @@ static ServerConfig parse_arguments(int ac, char **av) {
 
     config.tcp_port = ports["-p"];
     config.base_udp_port = ports["-u"];
+    if (config.udp_shards > 1 && config.game_workers == 0) {
+        std::cerr << "Error: -s needs -w, forked games own their UDP port"
+                  << std::endl;
+        show_helper();
+        return config;
+    }
+    if (config.broadcast_rate == 0)
+        config.broadcast_rate = config.tick_rate;
+    // Updates go out every N ticks, other rates would be silently rounded
+    if (config.tick_rate % config.broadcast_rate != 0) {
+        std::cerr << "Error: Broadcast rate after -b must divide the tick rate ("
+                  << config.tick_rate << " Hz)" << std::endl;
+        show_helper();
+        return config;
+    }
     config.valid = true;
 
     return config;
@@ -119,10 +232,21 @@ int main(int ac, char **av) {
     std::cout << "\nConfiguration:" << std::endl;
     std::cout << "  TCP Port (Lobby):  " << config.tcp_port << std::endl;
     std::cout << "  UDP Port (Base):   " << config.base_udp_port << std::endl;
+    std::cout << "  Tick Rate:         " << config.tick_rate << " Hz" << std::endl;
+    std::cout << "  Broadcast Rate:    " << config.broadcast_rate << " Hz"
+              << std::endl;
+    if (config.game_workers > 0) {
+        std::cout << "  Game Workers:      " << config.game_workers << std::endl;
+        std::cout << "  UDP Shards:        " << config.udp_shards << std::endl;
+        std::cout << "  Warm Instances:    " << config.warm_instances << std::endl;
+    }
     std::cout << "\nPress Ctrl+C to stop the server\n" << std::endl;
 
     try {
-        StartServer server(config.tcp_port, config.base_udp_port);
+        StartServer server(config.tcp_port, config.base_udp_port,
+                           config.tick_rate, config.broadcast_rate,
+                           config.game_workers, config.udp_shards,
+                           config.warm_instances);
 
         server.run();
 
@@ -4,9 +4,10 @@
 #include <cmath>
 #include <iostream>
 
-GameLogic::GameLogic(std::shared_ptr<registry> reg, uint8_t level_id)
+GameLogic::GameLogic(std::shared_ptr<registry> reg, uint8_t level_id, uint32_t tick_rate)
     : _registry(reg), _running(false), _current_tick(0), _game_time(0.0f),
-      _enemy_spawn_timer(0.0f), _enemy_spawn_interval(2.0f), _accumulator(0.0f),
+      _enemy_spawn_timer(0.0f), _enemy_spawn_interval(2.0f),
+      _fixed_timestep(1.0f / static_cast<float>(tick_rate > 0 ? tick_rate : 60)),
       _debug_timer(0.0f), _total_score(0), _boss_spawned(false), _boss_active(false),
       _boss(0), _level_id(level_id), _endless_mode(level_id == 99),
       _level_complete(false), _next_boss_threshold(300), _boss_count(0),
@@ -14,6 +15,9 @@ GameLogic::GameLogic(std::shared_ptr<registry> reg, uint8_t level_id)
       _next_net_id(1000) {
     _last_update = std::chrono::steady_clock::now();
     _rng.seed(std::random_device{}());
+    for (auto &frame : _snapshot_ring) {
+        frame.entities.reserve(SNAPSHOT_ENTITY_RESERVE);
+    }
     registerSystems();
 }
 
@@ -25,8 +29,11 @@ void GameLogic::start() {
     _game_time = 0.0f;
     _enemy_spawn_timer = -3.0f;
     _current_tick = 0;
-    _accumulator = 0.0f;
     _debug_timer = 0.0f;
+    for (auto &frame : _snapshot_ring) {
+        frame.valid = false;
+    }
+    _last_snapshot_tick = 0;
 }
 
 void GameLogic::stop() {
@@ -47,71 +54,57 @@ void GameLogic::registerSystems() {
 
 void GameLogic::printEntityPositions() {}
 
-void GameLogic::update(float deltaTime) {
+void GameLogic::step() {
     if (!_running)
         return;
 
-    static const float FIXED_TIMESTEP = 1.0f / 60.0f;
-
-    _accumulator += deltaTime;
+    const float dt = _fixed_timestep;
 
-    while (_accumulator >= FIXED_TIMESTEP) {
-        _current_tick++;
-        _game_time += FIXED_TIMESTEP;
+    _current_tick++;
+    _game_time += dt;
 
-        processEvents();
-        updatePlayerScores(FIXED_TIMESTEP);
-        _registry->run_systems(FIXED_TIMESTEP);
-        processPlayerShooting(FIXED_TIMESTEP);
-        processEnemyShooting(FIXED_TIMESTEP);
-        processBossShooting(FIXED_TIMESTEP);
-        processPowerUpCollisions();
-        updateCompanions(FIXED_TIMESTEP);
+    processEvents();
+    updatePlayerScores(dt);
+    _registry->run_systems(dt);
+    processPlayerShooting(dt);
+    processEnemyShooting(dt);
+    processBossShooting(dt);
+    processPowerUpCollisions();
+    updateCompanions(dt);
 
-        updateTotalScore();
+    updateTotalScore();
 
-        if (!_level_complete) {
-            checkBossSpawn();
+    if (!_level_complete) {
+        checkBossSpawn();
 
-            if (!_boss_active) {
-                _enemy_spawn_timer += FIXED_TIMESTEP;
-                if (_enemy_spawn_timer >= _enemy_spawn_interval) {
-                    _enemy_spawn_timer = 0.0f;
-                    spawnEnemy();
-                }
+        if (!_boss_active) {
+            _enemy_spawn_timer += dt;
+            if (_enemy_spawn_timer >= _enemy_spawn_interval) {
+                _enemy_spawn_timer = 0.0f;
+                spawnEnemy();
             }
         }
+    }
 
-        _powerup_spawn_timer += FIXED_TIMESTEP;
-        if (_powerup_spawn_timer >= _powerup_spawn_interval) {
-            _powerup_spawn_timer = 0.0f;
-            spawnPowerUp();
-        }
-
-        cleanupDeadEntities();
-        _accumulator -= FIXED_TIMESTEP;
+    _powerup_spawn_timer += dt;
+    if (_powerup_spawn_timer >= _powerup_spawn_interval) {
+        _powerup_spawn_timer = 0.0f;
+        spawnPowerUp();
     }
 
+    cleanupDeadEntities();
     _last_update = std::chrono::steady_clock::now();
 }
 
 void GameLogic::pushClientEvent(const ClientEvent &evt) {
-    std::lock_guard<std::mutex> lock(_event_mutex);
-    _event_queue.push(evt);
+    if (!_event_queue.tryPush([&evt](ClientEvent &slot) { slot = evt; })) {
+        std::cerr << "[GameLogic] Event queue full, dropping input from client "
+                  << evt.client_id << std::endl;
+    }
 }
 
 void GameLogic::processEvents() {
-    std::queue<ClientEvent> local_queue;
-    {
-        std::lock_guard<std::mutex> lock(_event_mutex);
-        std::swap(local_queue, _event_queue);
-    }
-
-    while (!local_queue.empty()) {
-        const ClientEvent &evt = local_queue.front();
-        handleEvent(evt);
-        local_queue.pop();
-    }
+    _event_queue.drain([this](const ClientEvent &evt) { handleEvent(evt); });
 }
 
 void GameLogic::handleEvent(const ClientEvent &evt) {
@@ -127,7 +120,6 @@ void GameLogic::handleEvent(const ClientEvent &evt) {
 
 void GameLogic::handlePlayerAction(entity player, InputEvent action) {
     auto &input_states = _registry->get_components<InputState>();
-    auto &network_comps = _registry->get_components<NetworkComponent>();
 
     auto &input_opt = input_states[player];
     if (!input_opt)
@@ -148,9 +140,26 @@ void GameLogic::handlePlayerAction(entity player, InputEvent action) {
     case KEY_SHOOT_RELEASE: input.shoot = false; break;
     default: break;
     }
+}
+
+void GameLogic::applyInputState(uint client_id, uint8_t buttons, bool fire) {
+    auto it = _client_to_entity.find(client_id);
+    if (it == _client_to_entity.end()) {
+        return;
+    }
 
-    auto &net_opt = network_comps[player];
-    if (net_opt) {
-        net_opt.value().needs_update = true;
+    auto &input_opt = _registry->get_components<InputState>()[it->second];
+    if (!input_opt)
+        return;
+
+    InputState &input = input_opt.value();
+    input.up = (buttons & network::INPUT_UP) != 0;
+    input.down = (buttons & network::INPUT_DOWN) != 0;
+    input.left = (buttons & network::INPUT_LEFT) != 0;
+    input.right = (buttons & network::INPUT_RIGHT) != 0;
+
+    // Shots are one-shot, the weapon system clears the flag once fired
+    if (fire) {
+        input.shoot = true;
     }
 }
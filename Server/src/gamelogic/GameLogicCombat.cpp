@@ -66,6 +66,7 @@ void GameLogic::updateBossPartsMovement(float dt) {
             float frequency = frequencies[idx];
             float offset_y = (idx == 1) ? -0.025f : 0.0f;
             pos.y = base_y + offset_y + std::sin(boss.phase_timer * frequency * 2.0f * 3.14159f) * amplitude;
+            markDirty(*_registry, part, network::FIELD_POSITION);
         }
     }
 }
@@ -96,7 +97,7 @@ void GameLogic::cleanupDeadBossParts() {
             if (dead == _boss) {
                 _boss = entity(0);
             }
-            _registry->kill_entity(dead);
+            destroyEntity(dead);
             _boss_parts.erase(it);
         }
     }
@@ -224,9 +225,11 @@ void GameLogic::processBossLevel1Shooting(float dt) {
         if (pos.y <= 0.1f) {
             vel_opt.value().vy = std::abs(vel_opt.value().vy);
             pos.y = 0.1f;
+            markDirty(*_registry, _boss, network::FIELD_POSITION);
         } else if (pos.y >= 0.9f) {
             vel_opt.value().vy = -std::abs(vel_opt.value().vy);
             pos.y = 0.9f;
+            markDirty(*_registry, _boss, network::FIELD_POSITION);
         }
     }
 
@@ -283,6 +286,7 @@ void GameLogic::applyPowerUpToPlayer(entity player_ent, PowerUpType type) {
         } else {
             _registry->add_component(player_ent, Shield{50, 50});
         }
+        markDirty(*_registry, player_ent, network::FIELD_SHIELD);
     } else if (type == PowerUpType::SPREAD) {
         auto &weapon_opt = weapons[player_ent];
         if (weapon_opt) {
@@ -293,6 +297,7 @@ void GameLogic::applyPowerUpToPlayer(entity player_ent, PowerUpType type) {
         auto &weapon_opt = weapons[player_ent];
         if (weapon_opt) {
             weapon_opt.value().damage_boost_timer = game::LASER_DURATION;
+            markDirty(*_registry, player_ent, network::FIELD_FLAGS);
         }
     } else if (type == PowerUpType::COMPANION) {
         auto &players = _registry->get_components<PlayerComponent>();
@@ -354,7 +359,7 @@ void GameLogic::processPowerUpCollisions() {
         if (net_opt) {
             _destroyed_net_ids.push_back(net_opt.value().net_id);
         }
-        _registry->kill_entity(pu);
+        destroyEntity(pu);
         _powerups.erase(std::remove(_powerups.begin(), _powerups.end(), pu), _powerups.end());
     }
 }
@@ -373,7 +378,7 @@ void GameLogic::cleanupDeadPlayers() {
             if (net_opt) {
                 _destroyed_net_ids.push_back(net_opt.value().net_id);
             }
-            _registry->kill_entity(ent);
+            destroyEntity(ent);
             it = _client_to_entity.erase(it);
         } else {
             ++it;
@@ -400,7 +405,7 @@ void GameLogic::cleanupDeadEnemies() {
             if (net_opt) {
                 _destroyed_net_ids.push_back(net_opt.value().net_id);
             }
-            _registry->kill_entity(ent);
+            destroyEntity(ent);
             it = _enemies.erase(it);
         } else {
             ++it;
@@ -430,7 +435,7 @@ void GameLogic::cleanupOutOfBoundsProjectiles() {
             if (net_opt) {
                 _destroyed_net_ids.push_back(net_opt.value().net_id);
             }
-            _registry->kill_entity(ent);
+            destroyEntity(ent);
             it = _projectiles.erase(it);
         } else {
             ++it;
@@ -449,7 +454,7 @@ void GameLogic::cleanupDeadBoss() {
             if (net_opt) {
                 _destroyed_net_ids.push_back(net_opt.value().net_id);
             }
-            _registry->kill_entity(_boss);
+            destroyEntity(_boss);
             _boss_active = false;
             _boss = entity(0);
         }
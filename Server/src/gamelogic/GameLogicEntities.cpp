@@ -39,10 +39,10 @@ void GameLogic::spawnEnemyLevel1() {
     _registry->add_component(enemy, Enemy{enemy_type, 0.0f, 5, 0.0f, 2.0f});
     _registry->add_component(enemy, Health{25, 25, 0.0f});
     _registry->add_component(enemy, Hitbox{50.0f, 58.0f, 0.0f, 0.0f});
-    _registry->add_component(enemy, NetworkComponent{net_id, true, "enemy"});
+    addNetworkComponent(enemy, net_id, EntityType::ENEMY);
 
     _enemies.push_back(enemy);
-    _new_entities.push_back({net_id, "enemy", 0.95f, spawn_y, 25, 0});
+    _new_entities.push_back({net_id, EntityType::ENEMY, 0.95f, spawn_y, 25, 0});
 }
 
 void GameLogic::spawnEnemyLevel2() {
@@ -63,18 +63,18 @@ void GameLogic::spawnEnemyLevel2() {
     float spawn_y = y_dist(_rng);
     uint net_id = generateNetId();
 
-    std::string entity_type;
+    EntityType entity_type;
     int hp;
     float hitbox_w, hitbox_h;
 
     if (is_spread) {
-        entity_type = "enemy_level2_spread";
+        entity_type = EntityType::ENEMY_LEVEL2_SPREAD;
         hp = 35;
         hitbox_w = 66.0f;
         hitbox_h = 62.0f;
         _registry->add_component(enemy, Enemy{11, 0.0f, 10, 0.0f, 0.8f});
     } else {
-        entity_type = "enemy_level2";
+        entity_type = EntityType::ENEMY_LEVEL2;
         hp = 25;
         hitbox_w = 44.0f;
         hitbox_h = 46.0f;
@@ -85,7 +85,7 @@ void GameLogic::spawnEnemyLevel2() {
     _registry->add_component(enemy, Velocity{-0.14f, 0.0f});
     _registry->add_component(enemy, Health{hp, hp, 0.0f});
     _registry->add_component(enemy, Hitbox{hitbox_w, hitbox_h, 0.0f, 0.0f});
-    _registry->add_component(enemy, NetworkComponent{net_id, true, entity_type});
+    addNetworkComponent(enemy, net_id, entity_type);
 
     _enemies.push_back(enemy);
     _new_entities.push_back({net_id, entity_type, 0.95f, spawn_y, hp, 0});
@@ -104,10 +104,10 @@ void GameLogic::spawnEnemyKamikaze() {
     _registry->add_component(enemy, Enemy{20, 0.0f, 5, 0.0f, 999.0f});
     _registry->add_component(enemy, Health{game::ENEMY_KAMIKAZE_HP, game::ENEMY_KAMIKAZE_HP, 0.0f});
     _registry->add_component(enemy, Hitbox{66.0f, 68.0f, 0.0f, 0.0f});
-    _registry->add_component(enemy, NetworkComponent{net_id, true, "enemy_kamikaze"});
+    addNetworkComponent(enemy, net_id, EntityType::ENEMY_KAMIKAZE);
 
     _enemies.push_back(enemy);
-    _new_entities.push_back({net_id, "enemy_kamikaze", 0.95f, spawn_y, game::ENEMY_KAMIKAZE_HP, 0});
+    _new_entities.push_back({net_id, EntityType::ENEMY_KAMIKAZE, 0.95f, spawn_y, game::ENEMY_KAMIKAZE_HP, 0});
 }
 
 void GameLogic::checkBossSpawn() {
@@ -156,12 +156,12 @@ void GameLogic::spawnBoss1() {
     _registry->add_component(_boss, Enemy{100, 0.0f, 100});
     _registry->add_component(_boss, Health{boss_hp, boss_hp, 0.0f});
     _registry->add_component(_boss, Hitbox{130.0f, 220.0f, 0.0f, 0.0f});
-    _registry->add_component(_boss, NetworkComponent{net_id, true, "boss"});
+    addNetworkComponent(_boss, net_id, EntityType::BOSS);
 
     _boss_active = true;
     _boss_spawned = true;
 
-    _new_entities.push_back({net_id, "boss", 0.85f, 0.5f, boss_hp, 0});
+    _new_entities.push_back({net_id, EntityType::BOSS, 0.85f, 0.5f, boss_hp, 0});
 }
 
 void GameLogic::spawnBossPart1(float boss_x, float boss_y, int part_hp) {
@@ -173,9 +173,9 @@ void GameLogic::spawnBossPart1(float boss_x, float boss_y, int part_hp) {
     _registry->add_component(part1, Enemy{101, 0.0f, 100});
     _registry->add_component(part1, Health{part_hp, part_hp, 0.0f});
     _registry->add_component(part1, Hitbox{116.0f, 69.0f, 0.0f, 0.0f});
-    _registry->add_component(part1, NetworkComponent{net_id1, true, "boss_level2_part1"});
+    addNetworkComponent(part1, net_id1, EntityType::BOSS_LEVEL2_PART1);
     _boss_parts.push_back(part1);
-    _new_entities.push_back({net_id1, "boss_level2_part1", boss_x - 0.075f, boss_y, part_hp, 0});
+    _new_entities.push_back({net_id1, EntityType::BOSS_LEVEL2_PART1, boss_x - 0.075f, boss_y, part_hp, 0});
 }
 
 void GameLogic::spawnBossPart2(float boss_x, float boss_y, int part_hp) {
@@ -187,10 +187,10 @@ void GameLogic::spawnBossPart2(float boss_x, float boss_y, int part_hp) {
     _registry->add_component(part2, Enemy{101, 0.0f, 100});
     _registry->add_component(part2, Health{part_hp, part_hp, 0.0f});
     _registry->add_component(part2, Hitbox{98.0f, 100.0f, 0.0f, 0.0f});
-    _registry->add_component(part2, NetworkComponent{net_id2, true, "boss_level2_part2"});
+    addNetworkComponent(part2, net_id2, EntityType::BOSS_LEVEL2_PART2);
     _boss_parts.push_back(part2);
     _boss = part2;
-    _new_entities.push_back({net_id2, "boss_level2_part2", boss_x, boss_y - 0.025f, part_hp, 0});
+    _new_entities.push_back({net_id2, EntityType::BOSS_LEVEL2_PART2, boss_x, boss_y - 0.025f, part_hp, 0});
 }
 
 void GameLogic::spawnBossPart3(float boss_x, float boss_y, int part_hp) {
@@ -202,9 +202,9 @@ void GameLogic::spawnBossPart3(float boss_x, float boss_y, int part_hp) {
     _registry->add_component(part3, Enemy{101, 0.0f, 100});
     _registry->add_component(part3, Health{part_hp, part_hp, 0.0f});
     _registry->add_component(part3, Hitbox{99.0f, 83.0f, 0.0f, 0.0f});
-    _registry->add_component(part3, NetworkComponent{net_id3, true, "boss_level2_part3"});
+    addNetworkComponent(part3, net_id3, EntityType::BOSS_LEVEL2_PART3);
     _boss_parts.push_back(part3);
-    _new_entities.push_back({net_id3, "boss_level2_part3", boss_x + 0.075f, boss_y, part_hp, 0});
+    _new_entities.push_back({net_id3, EntityType::BOSS_LEVEL2_PART3, boss_x + 0.075f, boss_y, part_hp, 0});
 }
 
 void GameLogic::spawnBoss2() {
@@ -239,11 +239,11 @@ void GameLogic::spawnProjectile(float x, float y, bool is_player_projectile, int
     _registry->add_component(proj, Projectile{is_player_projectile, damage, 5.0f});
     _registry->add_component(proj, Hitbox{8.0f, 8.0f, 0.0f, 0.0f});
 
-    std::string proj_type = is_player_projectile ? "allied_projectile" : "projectile";
-    _registry->add_component(proj, NetworkComponent{net_id, true, proj_type});
+    EntityType proj_type = is_player_projectile ? EntityType::ALLIED_PROJECTILE : EntityType::PROJECTILE;
+    addNetworkComponent(proj, net_id, proj_type);
 
     _projectiles.push_back(proj);
-    _new_entities.push_back({net_id, proj_type, x, y, 0, 0});
+    _new_entities.push_back({net_id, proj_type, x, y, 0, 0, proj_vx, 0.0f, _current_tick});
 }
 
 void GameLogic::spawnProjectileAtAngle(float x, float y, float angle, bool is_player_projectile, int damage) {
@@ -266,11 +266,11 @@ void GameLogic::spawnProjectileAtAngle(float x, float y, float angle, bool is_pl
     _registry->add_component(proj, Projectile{is_player_projectile, damage, 5.0f});
     _registry->add_component(proj, Hitbox{8.0f, 8.0f, 0.0f, 0.0f});
 
-    std::string proj_type = is_player_projectile ? "allied_projectile" : "projectile";
-    _registry->add_component(proj, NetworkComponent{net_id, true, proj_type});
+    EntityType proj_type = is_player_projectile ? EntityType::ALLIED_PROJECTILE : EntityType::PROJECTILE;
+    addNetworkComponent(proj, net_id, proj_type);
 
     _projectiles.push_back(proj);
-    _new_entities.push_back({net_id, proj_type, x, y, 0, 0});
+    _new_entities.push_back({net_id, proj_type, x, y, 0, 0, proj_vx, proj_vy, _current_tick});
 }
 
 void GameLogic::spawnPowerUp() {
@@ -283,21 +283,21 @@ void GameLogic::spawnPowerUp() {
     int type = type_dist(_rng);
     uint net_id = generateNetId();
 
-    std::string entity_type;
+    EntityType entity_type;
     if (type == 0)
-        entity_type = "powerup_shield";
+        entity_type = EntityType::POWERUP_SHIELD;
     else if (type == 1)
-        entity_type = "powerup_spread";
+        entity_type = EntityType::POWERUP_SPREAD;
     else if (type == 2)
-        entity_type = "powerup_laser";
+        entity_type = EntityType::POWERUP_LASER;
     else
-        entity_type = "powerup_companion";
+        entity_type = EntityType::POWERUP_COMPANION;
 
     _registry->add_component(powerup, Position{0.95f, spawn_y});
     _registry->add_component(powerup, Velocity{-0.125f, 0.0f});
     _registry->add_component(powerup, PowerUp{static_cast<PowerUpType>(type), 30.0f});
     _registry->add_component(powerup, Hitbox{42.0f, 34.0f, 0.0f, 0.0f});
-    _registry->add_component(powerup, NetworkComponent{net_id, true, entity_type});
+    addNetworkComponent(powerup, net_id, entity_type);
 
     _powerups.push_back(powerup);
     _new_entities.push_back({net_id, entity_type, 0.95f, spawn_y, 0, 0});
@@ -329,8 +329,8 @@ void GameLogic::spawnCompanionForPlayer(entity player_ent, uint client_id) {
     _registry->add_component(companion, Position{cx, cy});
     _registry->add_component(companion, Velocity{0.0f, 0.0f});
     _registry->add_component(companion, CompanionComponent{client_id, 0.0f, 3.0f / fire_rate});
-    _registry->add_component(companion, NetworkComponent{net_id, true, "companion"});
+    addNetworkComponent(companion, net_id, EntityType::COMPANION);
 
     _player_companions.emplace(client_id, companion);
-    _new_entities.push_back({net_id, "companion", cx, cy, 0, 0});
+    _new_entities.push_back({net_id, EntityType::COMPANION, cx, cy, 0, 0});
 }
@@ -13,7 +13,7 @@ entity GameLogic::createPlayer(uint client_id, uint net_id, float x, float y) {
     _registry->add_component(player, Score{0, 0.0f, 0.0f});
     _registry->add_component(player, Weapon{8.0f, 0.0f, 0, 25});
     _registry->add_component(player, Hitbox{66.0f, 34.0f, 15.0f, 0.0f});
-    _registry->add_component(player, NetworkComponent{net_id, true, "player"});
+    addNetworkComponent(player, net_id, EntityType::PLAYER);
 
     _client_to_entity.insert({client_id, player});
 
@@ -27,13 +27,13 @@ void GameLogic::removePlayer(uint client_id) {
         auto &net_comps = _registry->get_components<NetworkComponent>();
         if (net_comps[comp_it->second])
             _destroyed_net_ids.push_back(net_comps[comp_it->second].value().net_id);
-        _registry->kill_entity(comp_it->second);
+        destroyEntity(comp_it->second);
         _player_companions.erase(comp_it);
     }
 
     auto it = _client_to_entity.find(client_id);
     if (it != _client_to_entity.end()) {
-        _registry->kill_entity(it->second);
+        destroyEntity(it->second);
         _client_to_entity.erase(it);
     }
 }
@@ -45,18 +45,48 @@ entity GameLogic::getPlayerEntity(uint client_id) {
     return entity(static_cast<size_t>(-1));
 }
 
+bool GameLogic::getPlayerPosition(uint client_id, Position &out) {
+    auto it = _client_to_entity.find(client_id);
+    if (it == _client_to_entity.end())
+        return false;
+
+    auto &positions = _registry->get_components<Position>();
+    if (it->second >= positions.size() || !positions[it->second])
+        return false;
+
+    out = positions[it->second].value();
+    return true;
+}
+
 uint GameLogic::generateNetId() { return _next_net_id++; }
 
-std::vector<uint> GameLogic::getDestroyedEntities() {
-    std::vector<uint> result = std::move(_destroyed_net_ids);
-    _destroyed_net_ids.clear();
-    return result;
+void GameLogic::getDestroyedEntities(std::vector<uint> &out) {
+    out.clear();
+    out.swap(_destroyed_net_ids);
 }
 
-std::vector<GameLogic::NewEntityInfo> GameLogic::getNewEntities() {
-    std::vector<NewEntityInfo> result = std::move(_new_entities);
-    _new_entities.clear();
-    return result;
+void GameLogic::getNewEntities(std::vector<NewEntityInfo> &out) {
+    out.clear();
+    out.swap(_new_entities);
+}
+
+void GameLogic::getLiveProjectiles(std::vector<NewEntityInfo> &out) const {
+    out.clear();
+
+    auto &positions = _registry->get_components<Position>();
+    auto &velocities = _registry->get_components<Velocity>();
+    auto &network_comps = _registry->get_components<NetworkComponent>();
+
+    for (entity proj : _projectiles) {
+        const auto &pos_opt = positions[proj];
+        const auto &vel_opt = velocities[proj];
+        const auto &net_opt = network_comps[proj];
+        if (!pos_opt || !vel_opt || !net_opt)
+            continue;
+
+        out.push_back({net_opt->net_id, net_opt->entity_type, pos_opt->x, pos_opt->y, 0, 0,
+                       vel_opt->vx, vel_opt->vy, _current_tick});
+    }
 }
 
 void GameLogic::updatePlayerScores(float dt) {
@@ -83,6 +113,7 @@ void GameLogic::updatePlayerScores(float dt) {
 
         if (time_since_award >= SCORE_INTERVAL) {
             score_opt.value().current_score += 1;
+            markDirty(*_registry, i, network::FIELD_SCORE);
             score_opt.value().last_time_point_awarded = score_opt.value().survival_time;
         }
     }
@@ -126,7 +157,6 @@ void GameLogic::processPlayerShooting(float dt) {
     auto &positions = _registry->get_components<Position>();
     auto &weapons = _registry->get_components<Weapon>();
     auto &players = _registry->get_components<PlayerComponent>();
-    auto &network_comps = _registry->get_components<NetworkComponent>();
 
     for (size_t i = 0; i < players.size(); ++i) {
         auto &player_opt = players[i];
@@ -190,12 +220,14 @@ void GameLogic::processPlayerShooting(float dt) {
                     int dmg = static_cast<int>(game::BEAM_DPS * dt);
                     if (dmg < 1) dmg = 1;
                     healths[e].value().current_hp -= dmg;
-                    auto &enet = network_comps[e];
-                    if (enet) enet.value().needs_update = true;
+                    markDirty(*_registry, e, network::FIELD_HEALTH);
                 }
             }
 
-            weapon.damage_boost_timer = std::max(0.0f, weapon.damage_boost_timer);
+            if (weapon.damage_boost_timer <= 0.0f) {
+                weapon.damage_boost_timer = 0.0f;
+                markDirty(*_registry, i, network::FIELD_FLAGS);
+            }
             input.shoot = false;
             continue;
         }
@@ -211,11 +243,6 @@ void GameLogic::processPlayerShooting(float dt) {
 
             weapon.fire_timer = 1.0f / weapon.fire_rate;
             input.shoot = false;
-
-            auto &net_opt = network_comps[i];
-            if (net_opt) {
-                net_opt.value().needs_update = true;
-            }
         }
     }
 }
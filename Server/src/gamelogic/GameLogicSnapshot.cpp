@@ -1,6 +1,21 @@
 #include "gamelogic/GameLogic.hpp"
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
+
+namespace {
+
+// Moves pos forward through states (sorted by net_id) up to net_id. Called
+// with increasing net_ids, diffing two frames becomes a merge of sorted arrays
+const EntityState *advanceTo(const std::vector<EntityState> &states, size_t &pos,
+                             uint net_id) {
+    while (pos < states.size() && states[pos].net_id < net_id) {
+        ++pos;
+    }
+    return (pos < states.size() && states[pos].net_id == net_id) ? &states[pos] : nullptr;
+}
+
+} // namespace
 
 WorldSnapshot GameLogic::generateSnapshot() {
     WorldSnapshot snapshot;
@@ -15,12 +30,12 @@ WorldSnapshot GameLogic::generateSnapshot() {
     auto &weapons = _registry->get_components<Weapon>();
     auto &network_comps = _registry->get_components<NetworkComponent>();
 
-    for (size_t i = 0; i < network_comps.size(); ++i) {
-        auto net_opt = network_comps[i];
+    for (const NetEntity &net_ent : _net_entities) {
+        entity ent = net_ent.ent;
+        auto net_opt = network_comps[ent];
         if (!net_opt)
             continue;
 
-        entity ent = _registry->entity_from_index(i);
         auto pos_opt = positions[ent];
         auto vel_opt = velocities[ent];
 
@@ -40,77 +55,169 @@ WorldSnapshot GameLogic::generateSnapshot() {
         }
     }
 
-    _snapshot_history.push_back(snapshot);
-    if (_snapshot_history.size() > MAX_SNAPSHOT_HISTORY) {
-        _snapshot_history.pop_front();
+    return snapshot;
+}
+
+uint GameLogic::captureSnapshot() {
+    SnapshotFrame &frame = _snapshot_ring[_current_tick % SNAPSHOT_RING_SIZE];
+    frame.tick = _current_tick;
+    frame.valid = true;
+    frame.entities.clear();
+
+    auto &positions = _registry->get_components<Position>();
+    auto &healths = _registry->get_components<Health>();
+    auto &shields = _registry->get_components<Shield>();
+    auto &scores = _registry->get_components<Score>();
+    auto &weapons = _registry->get_components<Weapon>();
+    auto &network_comps = _registry->get_components<NetworkComponent>();
+
+    for (const NetEntity &net_ent : _net_entities) {
+        size_t i = net_ent.ent;
+        const auto &net_opt = network_comps[i];
+        if (!net_opt || i >= positions.size() || !positions[i])
+            continue;
+
+        const Position &pos = positions[i].value();
+        EntityState state;
+        state.net_id = net_opt->net_id;
+        state.type = net_opt->entity_type;
+        state.x = pos.x;
+        state.y = pos.y;
+        state.health = (i < healths.size() && healths[i]) ? healths[i]->current_hp : 0;
+        state.shield = (i < shields.size() && shields[i]) ? shields[i]->current_shield : 0;
+        state.score = (i < scores.size() && scores[i]) ? scores[i]->current_score : 0;
+        state.flags = (i < weapons.size() && weapons[i] && weapons[i]->damage_boost_timer > 0.0f) ? 0x01 : 0x00;
+        state.fields = net_opt->dirty_fields;
+        frame.entities.push_back(state);
     }
 
-    return snapshot;
+    std::sort(frame.entities.begin(), frame.entities.end(),
+              [](const EntityState &a, const EntityState &b) { return a.net_id < b.net_id; });
+
+    _last_snapshot_tick = _current_tick;
+    return _current_tick;
 }
 
-std::vector<EntitySnapshot> GameLogic::getDeltaSnapshot(uint last_acked_tick) {
-    auto acked_snapshot =
-        std::find_if(_snapshot_history.begin(), _snapshot_history.end(),
-                     [last_acked_tick](const WorldSnapshot &s) {
-                         return s.tick == last_acked_tick;
-                     });
+bool GameLogic::hasSnapshot(uint tick) const {
+    const SnapshotFrame &frame = _snapshot_ring[tick % SNAPSHOT_RING_SIZE];
+    return frame.valid && frame.tick == tick;
+}
+
+void GameLogic::getDeltaSnapshot(uint last_acked_tick, std::vector<EntityState> &out) const {
+    out.clear();
 
-    if (acked_snapshot == _snapshot_history.end()) {
-        auto current = generateSnapshot();
-        return current.entities;
+    const SnapshotFrame &current = _snapshot_ring[_last_snapshot_tick % SNAPSHOT_RING_SIZE];
+    if (!current.valid) {
+        return;
     }
 
-    std::unordered_map<uint, EntitySnapshot> old_entities;
-    for (const auto &entity : acked_snapshot->entities) {
-        old_entities[entity.net_id] = entity;
+    if (last_acked_tick == 0 || last_acked_tick > _last_snapshot_tick ||
+        _last_snapshot_tick - last_acked_tick >= SNAPSHOT_RING_SIZE ||
+        !hasSnapshot(last_acked_tick)) {
+        out = current.entities;
+        for (EntityState &state : out) {
+            state.fields = network::FIELD_ALL;
+        }
+        return;
     }
 
-    std::vector<EntitySnapshot> delta;
-    auto current_snapshot = generateSnapshot();
+    const std::vector<EntityState> &baseline =
+        _snapshot_ring[last_acked_tick % SNAPSHOT_RING_SIZE].entities;
+
+    // Frames captured after the baseline, their masks tell which fields were written
+    std::array<const SnapshotFrame *, SNAPSHOT_RING_SIZE> since;
+    size_t since_count = 0;
+    for (const SnapshotFrame &frame : _snapshot_ring) {
+        if (frame.valid && frame.tick > last_acked_tick && frame.tick <= _last_snapshot_tick) {
+            since[since_count++] = &frame;
+        }
+    }
 
-    const float POS_THRESHOLD = 5.0f;
+    // Positions are normalized, this is well under a pixel on any window
+    const float POS_EPSILON = 0.0001f;
 
-    for (const auto &entity : current_snapshot.entities) {
-        auto old_it = old_entities.find(entity.net_id);
-        bool should_send = false;
+    size_t baseline_pos = 0;
+    std::array<size_t, SNAPSHOT_RING_SIZE> since_pos{};
 
-        if (old_it == old_entities.end()) {
-            should_send = true;
-        } else {
-            const EntitySnapshot &old = old_it->second;
-            float pos_delta = std::sqrt(std::pow(entity.pos.x - old.pos.x, 2) +
-                                        std::pow(entity.pos.y - old.pos.y, 2));
+    for (const EntityState &state : current.entities) {
+        const EntityState *old = advanceTo(baseline, baseline_pos, state.net_id);
+        if (!old) {
+            out.push_back(state);
+            out.back().fields = network::FIELD_ALL;
+            continue;
+        }
 
-            should_send = (pos_delta > POS_THRESHOLD || entity.health != old.health ||
-                          entity.shield != old.shield || entity.score != old.score ||
-                          entity.beam_active != old.beam_active);
+        uint8_t written = 0;
+        for (size_t k = 0; k < since_count && written != network::FIELD_ALL; ++k) {
+            const EntityState *mid = advanceTo(since[k]->entities, since_pos[k], state.net_id);
+            written |= mid ? mid->fields : static_cast<uint8_t>(network::FIELD_ALL);
         }
 
-        if (should_send) {
-            delta.push_back(entity);
+        uint8_t changed = 0;
+        if ((written & network::FIELD_POSITION) &&
+            (std::fabs(state.x - old->x) > POS_EPSILON || std::fabs(state.y - old->y) > POS_EPSILON))
+            changed |= network::FIELD_POSITION;
+        if ((written & network::FIELD_HEALTH) && state.health != old->health)
+            changed |= network::FIELD_HEALTH;
+        if ((written & network::FIELD_SHIELD) && state.shield != old->shield)
+            changed |= network::FIELD_SHIELD;
+        if ((written & network::FIELD_SCORE) && state.score != old->score)
+            changed |= network::FIELD_SCORE;
+        if ((written & network::FIELD_FLAGS) && state.flags != old->flags)
+            changed |= network::FIELD_FLAGS;
+
+        if (changed) {
+            out.push_back(state);
+            out.back().fields = changed;
         }
     }
-
-    return delta;
 }
 
 void GameLogic::markEntitiesSynced() {
     auto &network_comps = _registry->get_components<NetworkComponent>();
-    for (size_t i = 0; i < network_comps.size(); ++i) {
-        auto net_opt = network_comps[i];
+    for (const NetEntity &net_ent : _net_entities) {
+        auto &net_opt = network_comps[net_ent.ent];
         if (net_opt) {
-            net_opt.value().needs_update = false;
+            net_opt.value().dirty_fields = 0;
         }
     }
 }
 
+void GameLogic::markDirty(registry &reg, size_t entity_idx, uint8_t fields) {
+    auto &net_opt = reg.get_components<NetworkComponent>()[entity_idx];
+    if (net_opt) {
+        net_opt.value().dirty_fields |= fields;
+    }
+}
+
 entity GameLogic::findEntityByNetId(uint net_id) {
+    auto it = _net_id_slots.find(net_id);
+    if (it != _net_id_slots.end()) {
+        return _net_entities[it->second].ent;
+    }
+    return entity(static_cast<size_t>(-1));
+}
+
+void GameLogic::addNetworkComponent(entity ent, uint net_id, EntityType type) {
+    _registry->add_component(ent, NetworkComponent{net_id, network::FIELD_ALL, type});
+    _net_id_slots[net_id] = _net_entities.size();
+    _net_entities.push_back({net_id, ent});
+}
+
+void GameLogic::destroyEntity(entity ent) {
     auto &network_comps = _registry->get_components<NetworkComponent>();
-    for (size_t i = 0; i < network_comps.size(); ++i) {
-        auto net_opt = network_comps[i];
-        if (net_opt && net_opt.value().net_id == net_id) {
-            return _registry->entity_from_index(i);
+    if (ent < network_comps.size() && network_comps[ent]) {
+        auto it = _net_id_slots.find(network_comps[ent]->net_id);
+        if (it != _net_id_slots.end()) {
+            // Swap with the last slot so the index stays dense
+            size_t slot = it->second;
+            _net_id_slots.erase(it);
+            if (slot != _net_entities.size() - 1) {
+                _net_entities[slot] = _net_entities.back();
+                _net_id_slots[_net_entities[slot].net_id] = slot;
+            }
+            _net_entities.pop_back();
         }
     }
-    return entity(static_cast<size_t>(-1));
+    _registry->kill_entity(ent);
 }
@@ -1,5 +1,6 @@
 #include "gamelogic/GameLogic.hpp"
 #include "../../ecs/include/GameConstants.hpp"
+#include "network/PlayerMovement.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -8,7 +9,6 @@ void GameLogic::inputSystem(registry &reg, sparse_array<InputState> &inputs,
                             sparse_array<PlayerComponent> &players, float dt) {
     (void)reg;
     (void)dt;
-    const float MOVE_SPEED = 0.5f;
 
     for (size_t i = 0; i < players.size(); ++i) {
         auto &player_opt = players[i];
@@ -22,21 +22,9 @@ void GameLogic::inputSystem(registry &reg, sparse_array<InputState> &inputs,
             Velocity &vel = vel_opt.value();
             InputState &input = input_opt.value();
 
-            vel.vx = 0.0f;
-            vel.vy = 0.0f;
-
-            if (input.up)    vel.vy -= MOVE_SPEED;
-            if (input.down)  vel.vy += MOVE_SPEED;
-            if (input.left)  vel.vx -= MOVE_SPEED;
-            if (input.right) vel.vx += MOVE_SPEED;
-
-            if ((input.up || input.down) && (input.left || input.right)) {
-                float length = std::sqrt(vel.vx * vel.vx + vel.vy * vel.vy);
-                if (length > 0) {
-                    vel.vx = (vel.vx / length) * MOVE_SPEED;
-                    vel.vy = (vel.vy / length) * MOVE_SPEED;
-                }
-            }
+            // Shared with client-side prediction, keep both in lockstep
+            network::movement::inputVelocity(input.up, input.down, input.left,
+                                             input.right, vel.vx, vel.vy);
         }
     }
 }
@@ -53,14 +41,17 @@ void GameLogic::movementSystem(registry &reg, sparse_array<Position> &positions,
             Position &pos = pos_opt.value();
             Velocity &vel = vel_opt.value();
 
-            pos.x += vel.vx * dt;
-            pos.y += vel.vy * dt;
+            if (vel.vx == 0.0f && vel.vy == 0.0f)
+                continue;
 
             bool is_player = (i < players.size()) && players[i].has_value();
             if (is_player) {
-                pos.x = std::max(0.0f, std::min(pos.x, 1.0f));
-                pos.y = std::max(0.0f, std::min(pos.y, 1.0f));
+                network::movement::stepPlayer(pos.x, pos.y, vel.vx, vel.vy, dt);
+            } else {
+                pos.x += vel.vx * dt;
+                pos.y += vel.vy * dt;
             }
+            markDirty(reg, i, network::FIELD_POSITION);
         }
     }
 }
@@ -106,6 +97,7 @@ int GameLogic::applyDamageWithShield(registry &reg, size_t entity_idx, int damag
         int shield_damage = std::min(remaining_damage, shield_opt.value().current_shield);
         shield_opt.value().current_shield -= shield_damage;
         remaining_damage -= shield_damage;
+        markDirty(reg, entity_idx, network::FIELD_SHIELD);
     }
     return remaining_damage;
 }
@@ -114,8 +106,7 @@ void GameLogic::processProjectileCollisions(
     registry &reg, sparse_array<Position> &positions,
     sparse_array<Hitbox> &hitboxes, sparse_array<Projectile> &projectiles,
     sparse_array<PlayerComponent> &players, sparse_array<Enemy> &enemies,
-    sparse_array<Health> &healths, sparse_array<Score> &scores,
-    sparse_array<NetworkComponent> &network_comps) {
+    sparse_array<Health> &healths, sparse_array<Score> &scores) {
 
     for (size_t proj_idx = 0; proj_idx < projectiles.size(); ++proj_idx) {
         auto &proj_opt = projectiles[proj_idx];
@@ -181,10 +172,7 @@ void GameLogic::processProjectileCollisions(
 
                 target_health.current_hp -= remaining_damage;
 
-                auto &target_net_opt = network_comps[target_idx];
-                if (target_net_opt) {
-                    target_net_opt.value().needs_update = true;
-                }
+                markDirty(reg, target_idx, network::FIELD_HEALTH);
 
                 if (proj.is_player_projectile && target_is_enemy && hp_before > 0 && target_health.current_hp <= 0) {
                     auto &enemy_opt = enemies[target_idx];
@@ -195,6 +183,7 @@ void GameLogic::processProjectileCollisions(
                             auto &score_opt = scores[p_idx];
                             if (p_opt && score_opt) {
                                 score_opt.value().current_score += score_awarded;
+                                markDirty(reg, p_idx, network::FIELD_SCORE);
                                 break;
                             }
                         }
@@ -211,8 +200,7 @@ void GameLogic::processProjectileCollisions(
 void GameLogic::processContactCollisions(
     registry &reg, sparse_array<Position> &positions,
     sparse_array<Hitbox> &hitboxes, sparse_array<PlayerComponent> &players,
-    sparse_array<Enemy> &enemies, sparse_array<Health> &healths,
-    sparse_array<NetworkComponent> &network_comps) {
+    sparse_array<Enemy> &enemies, sparse_array<Health> &healths) {
 
     for (size_t player_idx = 0; player_idx < players.size(); ++player_idx) {
         auto &player_opt = players[player_idx];
@@ -264,7 +252,7 @@ void GameLogic::processContactCollisions(
                 auto &net_comps = reg.get_components<NetworkComponent>();
                 int contact_damage = game::CONTACT_DAMAGE;
                 if (enemy_idx < net_comps.size() && net_comps[enemy_idx]) {
-                    if (net_comps[enemy_idx].value().entity_type == "enemy_kamikaze") {
+                    if (net_comps[enemy_idx].value().entity_type == EntityType::ENEMY_KAMIKAZE) {
                         contact_damage = game::KAMIKAZE_CONTACT_DAMAGE;
                     }
                 }
@@ -276,14 +264,8 @@ void GameLogic::processContactCollisions(
 
                 player_health_opt.value().invulnerability_timer = 0.5f;
 
-                auto &player_net_opt = network_comps[player_idx];
-                if (player_net_opt) {
-                    player_net_opt.value().needs_update = true;
-                }
-                auto &enemy_net_opt = network_comps[enemy_idx];
-                if (enemy_net_opt) {
-                    enemy_net_opt.value().needs_update = true;
-                }
+                markDirty(reg, player_idx, network::FIELD_HEALTH);
+                markDirty(reg, enemy_idx, network::FIELD_HEALTH);
 
                 break;
             }
@@ -297,19 +279,21 @@ void GameLogic::collisionSystem(
     sparse_array<PlayerComponent> &players, sparse_array<Enemy> &enemies,
     sparse_array<Health> &healths, sparse_array<Score> &scores,
     sparse_array<NetworkComponent> &network_comps, float dt) {
+    // Written through markDirty, the system only needs entities that have one
+    (void)network_comps;
     (void)dt;
 
     processProjectileCollisions(reg, positions, hitboxes, projectiles, players,
-                                enemies, healths, scores, network_comps);
+                                enemies, healths, scores);
 
     processContactCollisions(reg, positions, hitboxes, players, enemies,
-                            healths, network_comps);
+                            healths);
 }
 
 void GameLogic::healthSystem(registry &reg, sparse_array<Health> &healths,
                              sparse_array<NetworkComponent> &network_comps,
                              float dt) {
-    (void)reg;
+    (void)network_comps;
     for (size_t i = 0; i < healths.size(); ++i) {
         auto &health_opt = healths[i];
         if (health_opt) {
@@ -318,10 +302,7 @@ void GameLogic::healthSystem(registry &reg, sparse_array<Health> &healths,
             }
 
             if (health_opt.value().current_hp <= 0) {
-                auto &net_opt = network_comps[i];
-                if (net_opt) {
-                    net_opt.value().needs_update = true;
-                }
+                markDirty(reg, i, network::FIELD_HEALTH);
             }
         }
     }
@@ -393,8 +374,7 @@ void GameLogic::updateCompanions(float dt) {
         companion_pos.x = player_pos.x + 0.05f;
         companion_pos.y = player_pos.y - 0.04f;
 
-        if (network_comps[companion_ent])
-            network_comps[companion_ent].value().needs_update = true;
+        markDirty(*_registry, companion_ent, network::FIELD_POSITION);
 
         // Auto-fire at 1/3 player fire rate
         CompanionComponent &comp = companions[companion_ent].value();
@@ -413,7 +393,7 @@ void GameLogic::updateCompanions(float dt) {
         entity c = it->second;
         if (network_comps[c])
             _destroyed_net_ids.push_back(network_comps[c].value().net_id);
-        _registry->kill_entity(c);
+        destroyEntity(c);
         _player_companions.erase(it);
     }
 }
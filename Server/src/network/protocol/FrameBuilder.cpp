@@ -0,0 +1,32 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** FrameBuilder.cpp
+*/
+
+#include "network/protocol/FrameBuilder.hpp"
+
+void FrameBuilder::reset(bool aggregate) {
+    _aggregate = aggregate;
+    _count = 0;
+}
+
+void FrameBuilder::append(const std::string &message) {
+    if (_count == 0 || !_aggregate ||
+        _datagrams[_count - 1].size() + message.size() > MAX_DATAGRAM_SIZE) {
+        nextDatagram().append(message);
+        return;
+    }
+    _datagrams[_count - 1].append(message);
+}
+
+std::string &FrameBuilder::nextDatagram() {
+    if (_count == _datagrams.size()) {
+        _datagrams.emplace_back();
+        _datagrams.back().reserve(MAX_DATAGRAM_SIZE);
+    }
+    std::string &datagram = _datagrams[_count++];
+    datagram.clear();
+    return datagram;
+}
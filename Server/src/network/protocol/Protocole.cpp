@@ -88,7 +88,8 @@ std::string Protocol::createReady() {
 }
 
 std::string Protocol::createGameStart(uint16_t udp_port, uint16_t server_id,
-                                      uint32_t server_ip, uint8_t level_id) {
+                                      uint32_t server_ip, uint8_t level_id,
+                                      uint64_t session_token) {
     std::vector<uint8_t> data;
 
     // Manual byte packing in big-endian order (no htons/htonl needed)
@@ -106,6 +107,11 @@ std::string Protocol::createGameStart(uint16_t udp_port, uint16_t server_id,
     // Add level_id (1=Level1, 2=Level2, 99=Endless)
     data.push_back(level_id);
 
+    // Session token, prefixed to every UDP datagram of a shared port (0 = none)
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        data.push_back(static_cast<uint8_t>((session_token >> shift) & 0xFF));
+    }
+
     return createMessage(MessageType::TCP_GAME_START, data);
 }
 
@@ -0,0 +1,41 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** ReliableChannel.cpp
+*/
+
+#include "network/protocol/ReliableChannel.hpp"
+#include "network/protocol/UdpMessageType.hpp"
+#include <algorithm>
+
+const std::string &ReliableChannel::send(const std::string &message, uint32_t tick) {
+    uint32_t sequence = _next_sequence++;
+    _entries.push_back({sequence, tick, message});
+
+    // SEQUENCE_NUM, big endian, follows MSG_TYPE and DATA_LENGTH
+    std::string &stamped = _entries.back().message;
+    if (stamped.size() >= UDP_HEADER_SIZE) {
+        stamped[4] = static_cast<char>((sequence >> 24) & 0xFF);
+        stamped[5] = static_cast<char>((sequence >> 16) & 0xFF);
+        stamped[6] = static_cast<char>((sequence >> 8) & 0xFF);
+        stamped[7] = static_cast<char>(sequence & 0xFF);
+    }
+    return stamped;
+}
+
+void ReliableChannel::acknowledge(uint32_t delivered, uint32_t received_bits) {
+    while (!_entries.empty() && _entries.front().sequence <= delivered) {
+        _entries.pop_front();
+    }
+    if (received_bits == 0) {
+        return;
+    }
+
+    _entries.erase(std::remove_if(_entries.begin(), _entries.end(),
+                                  [delivered, received_bits](const Entry &entry) {
+                                      uint32_t offset = entry.sequence - delivered - 2;
+                                      return offset < 32 && (received_bits >> offset) & 1u;
+                                  }),
+                   _entries.end());
+}
@@ -6,6 +6,7 @@
 */
 
 #include "network/protocol/UdpProtocole.hpp"
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cstring>
 #include <iostream>
@@ -13,30 +14,39 @@
 UdpProtocole::UdpProtocole() {}
 
 ParsedUdpMessage UdpProtocole::parseMessage(const std::string &raw_message) {
-    ParsedUdpMessage result = {UdpMessageType::CLIENT_PING, 0, {}, false};
+    UdpMessageView view = parseMessageView(
+        reinterpret_cast<const uint8_t *>(raw_message.data()), raw_message.size());
+    ParsedUdpMessage result = {view.type, view.sequence_num, {}, view.valid};
 
-    if (raw_message.size() < UDP_HEADER_SIZE) {
-        std::cerr << "UDP Message too short: " << raw_message.size() << " bytes"
+    if (view.valid && !view.data.empty()) {
+        result.data.assign(view.data.data(), view.data.data() + view.data.size());
+    }
+    return result;
+}
+
+UdpMessageView UdpProtocole::parseMessageView(const uint8_t *raw, size_t size) {
+    UdpMessageView result = {UdpMessageType::CLIENT_PING, 0, {}, false};
+
+    if (size < UDP_HEADER_SIZE) {
+        std::cerr << "UDP Message too short: " << size << " bytes"
                   << std::endl;
         return result;
     }
 
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(raw_message.data());
-
-    uint8_t msg_type = data[0];
+    uint8_t msg_type = raw[0];
     if (!isValidMessageType(msg_type)) {
         std::cerr << "Invalid UDP message type: " << static_cast<int>(msg_type)
                   << std::endl;
         return result;
     }
 
-    uint32_t data_length = extractDataLength(data);
-    uint32_t sequence_num = extractSequenceNum(data);
+    uint32_t data_length = extractDataLength(raw);
+    uint32_t sequence_num = extractSequenceNum(raw);
 
-    if (raw_message.size() != UDP_HEADER_SIZE + data_length) {
+    if (size != UDP_HEADER_SIZE + data_length) {
         std::cerr << "Invalid UDP message size. Expected: "
                   << UDP_HEADER_SIZE + data_length
-                  << ", Got: " << raw_message.size() << std::endl;
+                  << ", Got: " << size << std::endl;
         return result;
     }
 
@@ -46,32 +56,28 @@ ParsedUdpMessage UdpProtocole::parseMessage(const std::string &raw_message) {
         return result;
     }
 
-    std::vector<uint8_t> payload;
-    if (data_length > 0) {
-        payload.assign(data + UDP_HEADER_SIZE,
-                       data + UDP_HEADER_SIZE + data_length);
-    }
-
     result.type = type;
     result.sequence_num = sequence_num;
-    result.data = payload;
+    result.data = UdpPayloadView(raw + UDP_HEADER_SIZE, data_length);
     result.valid = true;
 
     return result;
 }
 
 std::string UdpProtocole::createPlayerAssignment(uint32_t player_net_id,
+                                                 uint8_t tick_rate,
                                                  uint32_t sequence_num) {
-    std::vector<uint8_t> data(4);
+    std::vector<uint8_t> data(PLAYER_ASSIGNMENT_SIZE);
     uint32_t net_id_network = htonl(player_net_id);
     std::memcpy(data.data(), &net_id_network, 4);
+    data[4] = tick_rate;
     return createMessage(UdpMessageType::PLAYER_ASSIGNMENT, sequence_num, data);
 }
 
-std::string UdpProtocole::createEntityCreate(const Entity &entity,
-                                             uint32_t sequence_num) {
-    std::vector<uint8_t> data(ENTITY_CREATE_SIZE);
-    uint8_t *ptr = data.data();
+void UdpProtocole::createEntityCreate(const Entity &entity,
+                                      uint32_t sequence_num, std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::ENTITY_CREATE, sequence_num,
+                                ENTITY_CREATE_SIZE);
 
     uint32_t net_id_network = htonl(entity.net_id);
     std::memcpy(ptr, &net_id_network, 4);
@@ -94,17 +100,24 @@ std::string UdpProtocole::createEntityCreate(const Entity &entity,
 
     uint32_t pos_y_network = htonf(entity.position_y);
     std::memcpy(ptr, &pos_y_network, 4);
-
-    return createMessage(UdpMessageType::ENTITY_CREATE, sequence_num, data);
 }
 
-std::string
-UdpProtocole::createEntityUpdate(const std::vector<Entity> &entities,
-                                 uint32_t sequence_num) {
-    std::vector<uint8_t> data(entities.size() * ENTITY_UPDATE_SIZE);
-    uint8_t *ptr = data.data();
+void UdpProtocole::createEntityUpdate(uint32_t snapshot_tick, uint8_t chunk_index,
+                                      uint8_t chunk_count, const Entity *entities,
+                                      size_t count, uint32_t sequence_num,
+                                      std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::ENTITY_UPDATE, sequence_num,
+                                UPDATE_HEADER_SIZE + count * ENTITY_UPDATE_SIZE);
+
+    uint32_t tick_network = htonl(snapshot_tick);
+    std::memcpy(ptr, &tick_network, 4);
+    ptr += 4;
+    *ptr++ = chunk_index;
+    *ptr++ = chunk_count;
+
+    for (size_t i = 0; i < count; ++i) {
+        const Entity &entity = entities[i];
 
-    for (const auto &entity : entities) {
         uint32_t net_id_network = htonl(entity.net_id);
         std::memcpy(ptr, &net_id_network, 4);
         ptr += 4;
@@ -136,23 +149,93 @@ UdpProtocole::createEntityUpdate(const std::vector<Entity> &entities,
         *ptr = entity.flags;
         ptr += 1;
     }
+}
 
-    return createMessage(UdpMessageType::ENTITY_UPDATE, sequence_num, data);
+void UdpProtocole::createEntityUpdateCompact(uint32_t snapshot_tick,
+                                             uint8_t chunk_index, uint8_t chunk_count,
+                                             const Entity *entities, size_t count,
+                                             uint32_t sequence_num,
+                                             std::string &out) {
+    _compact_entities.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const Entity &entity = entities[i];
+        network::CompactEntity compact;
+        compact.net_id = entity.net_id;
+        compact.entity_type = static_cast<uint8_t>(entity.type);
+        compact.health = entity.health;
+        compact.shield = entity.shield;
+        compact.position_x = entity.position_x;
+        compact.position_y = entity.position_y;
+        compact.score = entity.score;
+        compact.flags = entity.flags;
+        compact.fields = entity.fields;
+        _compact_entities.push_back(compact);
+    }
+    // net_ids are delta-coded, keep them ascending
+    std::sort(_compact_entities.begin(), _compact_entities.end(),
+              [](const network::CompactEntity &a, const network::CompactEntity &b) {
+                  return a.net_id < b.net_id;
+              });
+
+    // Byte-aligned writes, same bytes as the ENTITY_UPDATE header
+    _bit_writer.clear();
+    _bit_writer.writeBits(snapshot_tick, 32);
+    _bit_writer.writeBits(chunk_index, 8);
+    _bit_writer.writeBits(chunk_count, 8);
+    network::compact::encode(_bit_writer, _compact_entities);
+
+    const std::vector<uint8_t> &data = _bit_writer.data();
+    uint8_t *ptr = beginMessage(out, UdpMessageType::ENTITY_UPDATE_COMPACT,
+                                sequence_num, data.size());
+    std::memcpy(ptr, data.data(), data.size());
 }
 
-std::string
-UdpProtocole::createEntityDestroy(const std::vector<uint32_t> &net_ids,
-                                  uint32_t sequence_num) {
-    std::vector<uint8_t> data(net_ids.size() * 4);
-    uint8_t *ptr = data.data();
+void UdpProtocole::createEntityDestroy(const uint32_t *net_ids, size_t count,
+                                       uint32_t sequence_num, std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::ENTITY_DESTROY, sequence_num,
+                                count * 4);
 
-    for (uint32_t net_id : net_ids) {
-        uint32_t net_id_network = htonl(net_id);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t net_id_network = htonl(net_ids[i]);
         std::memcpy(ptr, &net_id_network, 4);
         ptr += 4;
     }
+}
+
+void UdpProtocole::createProjectileSpawn(uint32_t server_tick, uint8_t tick_rate,
+                                         const ProjectileSpawn *projectiles,
+                                         size_t count, uint32_t sequence_num,
+                                         std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::PROJECTILE_SPAWN, sequence_num,
+                                PROJECTILE_SPAWN_HEADER_SIZE +
+                                    count * PROJECTILE_SPAWN_SIZE);
+
+    uint32_t tick_network = htonl(server_tick);
+    std::memcpy(ptr, &tick_network, 4);
+    ptr += 4;
+    *ptr++ = tick_rate;
+
+    for (size_t i = 0; i < count; ++i) {
+        const ProjectileSpawn &projectile = projectiles[i];
+
+        uint32_t net_id_network = htonl(projectile.net_id);
+        std::memcpy(ptr, &net_id_network, 4);
+        ptr += 4;
+
+        *ptr++ = static_cast<uint8_t>(projectile.type);
+
+        uint32_t spawn_tick_network = htonl(projectile.spawn_tick);
+        std::memcpy(ptr, &spawn_tick_network, 4);
+        ptr += 4;
 
-    return createMessage(UdpMessageType::ENTITY_DESTROY, sequence_num, data);
+        const float values[4] = {projectile.origin_x, projectile.origin_y,
+                                 projectile.velocity_x, projectile.velocity_y};
+        for (float value : values) {
+            uint32_t value_network = htonf(value);
+            std::memcpy(ptr, &value_network, 4);
+            ptr += 4;
+        }
+    }
 }
 
 std::string UdpProtocole::createGameState(const std::vector<Entity> &entities,
@@ -192,12 +275,91 @@ std::string UdpProtocole::createGameState(const std::vector<Entity> &entities,
     return createMessage(UdpMessageType::GAME_STATE, sequence_num, data);
 }
 
+void UdpProtocole::createInputAck(uint32_t snapshot_tick, uint32_t input_sequence,
+                                  uint32_t sequence_num, std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::INPUT_ACK, sequence_num,
+                                INPUT_ACK_SIZE);
+
+    uint32_t tick_network = htonl(snapshot_tick);
+    uint32_t input_network = htonl(input_sequence);
+    std::memcpy(ptr, &tick_network, 4);
+    std::memcpy(ptr + 4, &input_network, 4);
+}
+
+void UdpProtocole::createEntityDeferred(uint32_t snapshot_tick, const uint32_t *net_ids,
+                                        size_t count, uint32_t sequence_num,
+                                        std::string &out) {
+    uint8_t *ptr = beginMessage(out, UdpMessageType::ENTITY_DEFERRED, sequence_num,
+                                SNAPSHOT_TICK_SIZE + count * 4);
+
+    uint32_t tick_network = htonl(snapshot_tick);
+    std::memcpy(ptr, &tick_network, 4);
+    ptr += 4;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t net_id_network = htonl(net_ids[i]);
+        std::memcpy(ptr, &net_id_network, 4);
+        ptr += 4;
+    }
+}
+
 std::string UdpProtocole::createVictory(uint32_t sequence_num) {
     // Empty payload - just the message type
     std::vector<uint8_t> data;
     return createMessage(UdpMessageType::VICTORY, sequence_num, data);
 }
 
+uint32_t UdpProtocole::parseSnapshotAck(UdpPayloadView data) {
+    if (data.size() < SNAPSHOT_ACK_SIZE) {
+        return 0;
+    }
+    uint32_t tick_network;
+    std::memcpy(&tick_network, data.data(), 4);
+    return ntohl(tick_network);
+}
+
+bool UdpProtocole::parseReliableAck(UdpPayloadView data, uint32_t &delivered,
+                                    uint32_t &received_bits) {
+    if (data.size() < SNAPSHOT_ACK_RELIABLE_SIZE) {
+        return false;
+    }
+    uint32_t delivered_network;
+    uint32_t bits_network;
+    std::memcpy(&delivered_network, data.data() + SNAPSHOT_ACK_SIZE, 4);
+    std::memcpy(&bits_network, data.data() + SNAPSHOT_ACK_SIZE + 4, 4);
+    delivered = ntohl(delivered_network);
+    received_bits = ntohl(bits_network);
+    return true;
+}
+
+uint8_t UdpProtocole::parseClientCapabilities(UdpPayloadView data) {
+    if (data.size() < CLIENT_PING_CAPS_SIZE) {
+        return 0;
+    }
+    return data[CLIENT_PING_SIZE];
+}
+
+size_t UdpProtocole::parseInputState(UdpPayloadView data, InputFrame *frames,
+                                     size_t max_frames) {
+    if (data.empty() || data[0] == 0 ||
+        data.size() != 1 + static_cast<size_t>(data[0]) * INPUT_FRAME_SIZE) {
+        return 0;
+    }
+
+    size_t count = std::min<size_t>(data[0], max_frames);
+
+    // Frames come newest first
+    const uint8_t *ptr = data.data() + 1;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t sequence_network;
+        std::memcpy(&sequence_network, ptr, 4);
+        frames[i].sequence = ntohl(sequence_network);
+        frames[i].buttons = ptr[4];
+        ptr += INPUT_FRAME_SIZE;
+    }
+    return count;
+}
+
 uint32_t UdpProtocole::extractHealth24bit(const uint8_t *data) {
     uint32_t health = 0;
     health |= (static_cast<uint32_t>(data[0]) << 16);
@@ -243,26 +405,33 @@ std::string UdpProtocole::createMessage(UdpMessageType type,
                                         uint32_t sequence_num,
                                         const std::vector<uint8_t> &data) {
     std::string message;
-    message.reserve(UDP_HEADER_SIZE + data.size());
+    uint8_t *ptr = beginMessage(message, type, sequence_num, data.size());
+    if (!data.empty()) {
+        std::memcpy(ptr, data.data(), data.size());
+    }
+    return message;
+}
+
+uint8_t *UdpProtocole::beginMessage(std::string &out, UdpMessageType type,
+                                    uint32_t sequence_num, size_t data_size) {
+    // resize() keeps the capacity of a reused buffer
+    out.resize(UDP_HEADER_SIZE + data_size);
+    uint8_t *header = reinterpret_cast<uint8_t *>(&out[0]);
 
     // MSG_TYPE (1 byte)
-    message.push_back(static_cast<uint8_t>(type));
+    header[0] = static_cast<uint8_t>(type);
 
     // DATA_LENGTH (3 bytes, big endian)
-    uint32_t length = data.size();
-    message.push_back(static_cast<uint8_t>((length >> 16) & 0xFF));
-    message.push_back(static_cast<uint8_t>((length >> 8) & 0xFF));
-    message.push_back(static_cast<uint8_t>(length & 0xFF));
+    uint32_t length = static_cast<uint32_t>(data_size);
+    header[1] = static_cast<uint8_t>((length >> 16) & 0xFF);
+    header[2] = static_cast<uint8_t>((length >> 8) & 0xFF);
+    header[3] = static_cast<uint8_t>(length & 0xFF);
 
     // SEQUENCE_NUM (4 bytes, network byte order)
     uint32_t seq_network = htonl(sequence_num);
-    const uint8_t *seq_bytes = reinterpret_cast<const uint8_t *>(&seq_network);
-    message.append(reinterpret_cast<const char *>(seq_bytes), 4);
-
-    // DATA (variable length)
-    message.insert(message.end(), data.begin(), data.end());
+    std::memcpy(header + 4, &seq_network, 4);
 
-    return message;
+    return header + UDP_HEADER_SIZE;
 }
 
 bool UdpProtocole::isValidMessageType(uint8_t type) {
@@ -273,7 +442,13 @@ bool UdpProtocole::isValidMessageType(uint8_t type) {
     case UdpMessageType::ENTITY_UPDATE:
     case UdpMessageType::ENTITY_DESTROY:
     case UdpMessageType::GAME_STATE:
+    case UdpMessageType::ENTITY_UPDATE_COMPACT:
+    case UdpMessageType::PROJECTILE_SPAWN:
+    case UdpMessageType::INPUT_ACK:
+    case UdpMessageType::ENTITY_DEFERRED:
     case UdpMessageType::PLAYER_INPUT:
+    case UdpMessageType::SNAPSHOT_ACK:
+    case UdpMessageType::INPUT_STATE:
         return true;
     default:
         return false;
@@ -283,19 +458,34 @@ bool UdpProtocole::isValidMessageType(uint8_t type) {
 bool UdpProtocole::isValidDataLength(UdpMessageType type, uint32_t length) {
     switch (type) {
     case UdpMessageType::CLIENT_PING:
-        return length == 4;
+        return length == CLIENT_PING_SIZE || length == CLIENT_PING_CAPS_SIZE;
     case UdpMessageType::PLAYER_ASSIGNMENT:
-        return length == 4;
+        return length == PLAYER_ASSIGNMENT_SIZE;
     case UdpMessageType::ENTITY_CREATE:
         return length == ENTITY_CREATE_SIZE;
     case UdpMessageType::ENTITY_UPDATE:
-        return length > 0 && (length % ENTITY_UPDATE_SIZE) == 0;
+        return length >= UPDATE_HEADER_SIZE &&
+               ((length - UPDATE_HEADER_SIZE) % ENTITY_UPDATE_SIZE) == 0;
     case UdpMessageType::ENTITY_DESTROY:
         return length > 0 && (length % 4) == 0;
     case UdpMessageType::GAME_STATE:
         return length >= 4;
+    case UdpMessageType::ENTITY_UPDATE_COMPACT:
+        return length > UPDATE_HEADER_SIZE;
+    case UdpMessageType::PROJECTILE_SPAWN:
+        return length >= PROJECTILE_SPAWN_HEADER_SIZE &&
+               (length - PROJECTILE_SPAWN_HEADER_SIZE) % PROJECTILE_SPAWN_SIZE == 0;
+    case UdpMessageType::INPUT_ACK:
+        return length == INPUT_ACK_SIZE;
+    case UdpMessageType::ENTITY_DEFERRED:
+        return length >= SNAPSHOT_TICK_SIZE && (length - SNAPSHOT_TICK_SIZE) % 4 == 0;
     case UdpMessageType::PLAYER_INPUT:
         return length == 2;
+    case UdpMessageType::SNAPSHOT_ACK:
+        return length == SNAPSHOT_ACK_SIZE || length == SNAPSHOT_ACK_RELIABLE_SIZE;
+    case UdpMessageType::INPUT_STATE:
+        return length > 1 && (length - 1) % INPUT_FRAME_SIZE == 0 &&
+               (length - 1) / INPUT_FRAME_SIZE <= INPUT_STATE_MAX_FRAMES;
     default:
         return false;
     }
@@ -48,12 +48,7 @@ void TCPServer::start_read(std::shared_ptr<ClientConnection> client) {
         asio::buffer(*buf),
         [this, client, buf](std::error_code ec, std::size_t len) {
             if (!ec) {
-                ClientMessage msg;
-                msg.client_id = client->id;
-                msg.client_endpoint = client->endpoint;
-                msg.message = std::string(buf->data(), len);
-
-                enqueueMessage(msg);
+                enqueueMessage(client->id, client->endpoint, buf->data(), len);
                 start_read(client);
             } else {
                 unregisterClient(client->id);
@@ -6,69 +6,290 @@
 */
 
 #include "network/udp/UdpServer.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::unique_ptr<asio::ip::udp::socket> openSocket(asio::io_context &ctx, uint16_t port,
+                                                  bool reuse_port) {
+    if (!reuse_port) {
+        return std::make_unique<asio::ip::udp::socket>(
+            ctx, asio::ip::udp::endpoint(asio::ip::udp::v4(), port));
+    }
+
+    // The option has to be set on every socket of the group before bind
+    auto socket = std::make_unique<asio::ip::udp::socket>(ctx);
+    socket->open(asio::ip::udp::v4());
+#ifdef SO_REUSEPORT
+    int enable = 1;
+    if (::setsockopt(socket->native_handle(), SOL_SOCKET, SO_REUSEPORT, &enable,
+                     sizeof(enable)) != 0) {
+        throw std::runtime_error("SO_REUSEPORT unavailable");
+    }
+#else
+    throw std::runtime_error("SO_REUSEPORT unsupported on this platform");
+#endif
+    socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), port));
+    return socket;
+}
+
+void pinToCore(std::thread &thread, std::size_t core) {
+#ifdef __linux__
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+        std::cerr << "[UDPServer] Could not pin receive thread to core "
+                  << core % cores << std::endl;
+    }
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+} // namespace
 
 UDPServer::UDPServer(uint16_t port, uint32_t max_clients)
-    : socket_(ctx_, asio::ip::udp::endpoint(asio::ip::udp::v4(), port)),
+    : ctx_(std::make_unique<asio::io_context>()),
+      own_socket_(openSocket(*ctx_, port, false)), socket_(own_socket_.get()),
       max_clients_(max_clients) {
+    startReceiving();
+}
+
+UDPServer::UDPServer(uint16_t port, std::shared_ptr<SessionTable> sessions, bool reuse_port)
+    : ctx_(std::make_unique<asio::io_context>()),
+      own_socket_(openSocket(*ctx_, port, reuse_port)), socket_(own_socket_.get()),
+      max_clients_(0), sessions_(std::move(sessions)) {
+    startReceiving();
+}
+
+void UDPServer::startReceiving() {
+#ifdef __linux__
+    recv_buffers_.resize(RECV_BATCH_SIZE);
+    recv_addrs_.resize(RECV_BATCH_SIZE);
+    recv_iovs_.resize(RECV_BATCH_SIZE);
+    recv_msgs_.resize(RECV_BATCH_SIZE);
+    for (std::size_t i = 0; i < RECV_BATCH_SIZE; ++i) {
+        recv_iovs_[i].iov_base = recv_buffers_[i].data();
+        recv_iovs_[i].iov_len = RECV_BUFFER_SIZE;
+        std::memset(&recv_msgs_[i], 0, sizeof(mmsghdr));
+        recv_msgs_[i].msg_hdr.msg_name = &recv_addrs_[i];
+        recv_msgs_[i].msg_hdr.msg_iov = &recv_iovs_[i];
+        recv_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+    start_receive_batch();
+#else
     start_receive();
-    thread_ = std::thread([this]() { ctx_.run(); });
+#endif
+    thread_ = std::thread([this]() { ctx_->run(); });
+}
+
+UDPServer::UDPServer(UDPServer &shared_port, uint32_t max_clients)
+    : socket_(shared_port.socket_), max_clients_(max_clients),
+      shared_port_(&shared_port) {
+    session_token_ = shared_port.openSession(*this);
 }
 
 UDPServer::~UDPServer() {
-    ctx_.stop();
+    // Once closed, the shared port's receive threads no longer reach us
+    if (shared_port_) {
+        shared_port_->closeSession(session_token_);
+    }
+    shards_.clear();
+    if (ctx_) {
+        ctx_->stop();
+    }
     if (thread_.joinable())
         thread_.join();
 }
 
-void UDPServer::start_receive() {
-    auto buf = std::make_shared<std::array<char, 1024>>();
+std::unique_ptr<UDPServer> UDPServer::openSharedPort(uint16_t port, std::size_t shards) {
+    shards = std::max<std::size_t>(1, shards);
+    bool reuse_port = shards > 1;
+    auto sessions = std::make_shared<SessionTable>();
+
+    std::unique_ptr<UDPServer> shared_port(new UDPServer(port, sessions, reuse_port));
+    for (std::size_t i = 1; i < shards; ++i) {
+        shared_port->shards_.emplace_back(new UDPServer(port, sessions, reuse_port));
+    }
+
+    if (reuse_port) {
+        pinToCore(shared_port->thread_, 0);
+        for (std::size_t i = 1; i < shards; ++i) {
+            pinToCore(shared_port->shards_[i - 1]->thread_, i);
+        }
+    }
+    return shared_port;
+}
+
+uint64_t UDPServer::openSession(UDPServer &session) {
+    // Drawn from the OS source, the token is what keeps other games' clients out
+    std::random_device source;
+    std::unique_lock<std::shared_mutex> lock(sessions_->mutex);
+    uint64_t token;
+    do {
+        token = (static_cast<uint64_t>(source()) << 32) | source();
+    } while (token == 0 || sessions_->sessions.count(token) > 0);
+
+    sessions_->sessions[token] = &session;
+    return token;
+}
+
+void UDPServer::closeSession(uint64_t token) {
+    std::unique_lock<std::shared_mutex> lock(sessions_->mutex);
+    sessions_->sessions.erase(token);
+}
+
+void UDPServer::routeDatagram(const char *data, std::size_t len,
+                              const asio::ip::udp::endpoint &from) {
+    if (len < SESSION_TOKEN_SIZE) {
+        return;
+    }
+
+    uint64_t token = 0;
+    for (std::size_t i = 0; i < SESSION_TOKEN_SIZE; ++i) {
+        token = (token << 8) | static_cast<uint8_t>(data[i]);
+    }
 
-    socket_.async_receive_from(
-        asio::buffer(*buf), remote_endpoint_,
-        [this, buf](std::error_code ec, std::size_t len) {
+    // Unknown tokens are dropped silently, logging them would let a flood
+    // of spoofed datagrams flood the log too
+    std::shared_lock<std::shared_mutex> lock(sessions_->mutex);
+    auto it = sessions_->sessions.find(token);
+    if (it != sessions_->sessions.end()) {
+        it->second->handleDatagram(data + SESSION_TOKEN_SIZE,
+                                   len - SESSION_TOKEN_SIZE, from);
+    }
+}
+
+void UDPServer::start_receive() {
+    socket_->async_receive_from(
+        asio::buffer(recv_buffer_), remote_endpoint_,
+        [this](std::error_code ec, std::size_t len) {
             if (!ec && len > 0) {
-                auto existing_client = findClientByEndpoint(remote_endpoint_);
-
-                if (existing_client) {
-                    // Update last activity timestamp
-                    existing_client->last_activity = std::chrono::steady_clock::now();
-
-                    UdpClientMessage msg;
-                    msg.client_id = existing_client->id;
-                    msg.client_endpoint = existing_client->endpoint_str;
-                    msg.message = std::string(buf->data(), len);
-                    std::cout << "Received message from client "
-                              << existing_client->id << " ("
-                              << existing_client->endpoint_str << "): " << len
-                              << " bytes" << std::endl;
-                    enqueueMessage(msg);
-                } else if (canAcceptNewClient()) {
-                    uint32_t client_id = generateClientId();
-                    auto client = std::make_shared<UdpClientInfo>();
-                    client->id = client_id;
-                    client->endpoint = remote_endpoint_;
-                    client->endpoint_str = endpointToString(remote_endpoint_);
-                    client->is_active = true;
-                    client->last_activity = std::chrono::steady_clock::now();
-                    registerClient(client_id, client);
-                    UdpClientMessage msg;
-                    msg.client_id = client->id;
-                    msg.client_endpoint = client->endpoint_str;
-                    msg.message = std::string(buf->data(), len);
-                    enqueueMessage(msg);
-                } else {
-                    std::cerr << "Max clients reached (" << max_clients_
-                              << "). Ignoring new client from "
-                              << endpointToString(remote_endpoint_)
-                              << std::endl;
-                }
+                handleDatagram(recv_buffer_.data(), len, remote_endpoint_);
             }
 
             start_receive();
         });
 }
 
+#ifdef __linux__
+void UDPServer::start_receive_batch() {
+    socket_->async_wait(
+        asio::ip::udp::socket::wait_read, [this](std::error_code ec) {
+            if (ec == asio::error::operation_aborted) {
+                return;
+            }
+            if (!ec && !drainReceiveBatch()) {
+                // recvmmsg is unusable here, stay on the plain Asio path
+                start_receive();
+                return;
+            }
+
+            start_receive_batch();
+        });
+}
+
+bool UDPServer::drainReceiveBatch() {
+    while (true) {
+        for (auto &msg : recv_msgs_) {
+            msg.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            msg.msg_hdr.msg_flags = 0;
+        }
+
+        int count = ::recvmmsg(socket_->native_handle(), recv_msgs_.data(),
+                               static_cast<unsigned int>(RECV_BATCH_SIZE),
+                               MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[UDPServer] recvmmsg failed: " << std::strerror(errno)
+                      << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const mmsghdr &msg = recv_msgs_[i];
+            if (msg.msg_len == 0 || (msg.msg_hdr.msg_flags & MSG_TRUNC)) {
+                continue;
+            }
+
+            asio::ip::udp::endpoint from;
+            std::memcpy(from.data(), &recv_addrs_[i], msg.msg_hdr.msg_namelen);
+            from.resize(msg.msg_hdr.msg_namelen);
+            handleDatagram(recv_buffers_[i].data(), msg.msg_len, from);
+        }
+
+        // A short batch means the socket is drained
+        if (static_cast<std::size_t>(count) < RECV_BATCH_SIZE) {
+            return true;
+        }
+    }
+}
+#endif
+
+void UDPServer::handleDatagram(const char *data, std::size_t len,
+                               const asio::ip::udp::endpoint &from) {
+    if (sessions_) {
+        routeDatagram(data, len, from);
+        return;
+    }
+
+    auto existing_client = findClientByEndpoint(from);
+
+    if (existing_client) {
+        // Update last activity timestamp
+        existing_client->last_activity = std::chrono::steady_clock::now();
+        enqueueMessage(existing_client->id, data, len);
+    } else {
+        acceptClient(data, len, from);
+    }
+}
+
+void UDPServer::acceptClient(const char *data, std::size_t len,
+                             const asio::ip::udp::endpoint &from) {
+    // Receive shards of a shared port admit clients to one session
+    // concurrently, the check and the registration have to stay together.
+    // A given endpoint always hashes to the same shard.
+    std::lock_guard<std::mutex> accept_lock(accept_mutex_);
+    if (canAcceptNewClient()) {
+        uint32_t client_id = generateClientId();
+        auto client = std::make_shared<UdpClientInfo>();
+        client->id = client_id;
+        client->endpoint = from;
+        client->endpoint_str = endpointToString(from);
+        client->is_active = true;
+        client->last_activity = std::chrono::steady_clock::now();
+        registerClient(client_id, client);
+        enqueueMessage(client->id, data, len);
+    } else {
+        std::cerr << "Max clients reached (" << max_clients_
+                  << "). Ignoring new client from "
+                  << endpointToString(from) << std::endl;
+    }
+}
+
 bool UDPServer::canAcceptNewClient() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return clients_.size() < max_clients_;
@@ -83,7 +304,7 @@ bool UDPServer::sendToClient(uint32_t client_id, const std::string &message) {
     auto client = getClient(client_id);
     if (client && client->is_active) {
         try {
-            socket_.send_to(asio::buffer(message), client->endpoint);
+            socket_->send_to(asio::buffer(message), client->endpoint);
             return true;
         } catch (const std::exception &e) {
             std::cerr << "Error sending to client " << client_id << ": "
@@ -94,6 +315,125 @@ bool UDPServer::sendToClient(uint32_t client_id, const std::string &message) {
     return false;
 }
 
+bool UDPServer::queueToClient(uint32_t client_id, const std::string &message) {
+    auto client = getClient(client_id);
+    if (!client || !client->is_active) {
+        return false;
+    }
+
+    if (pending_count_ == pending_.size()) {
+        pending_.emplace_back();
+    }
+    PendingDatagram &pending = pending_[pending_count_++];
+    pending.endpoint = client->endpoint;
+    pending.data.assign(message);
+    return true;
+}
+
+void UDPServer::flush() {
+    std::size_t sent = 0;
+
+#ifdef __linux__
+    send_iovs_.resize(pending_count_);
+    send_msgs_.resize(pending_count_);
+    for (std::size_t i = 0; i < pending_count_; ++i) {
+        PendingDatagram &pending = pending_[i];
+        send_iovs_[i].iov_base = pending.data.data();
+        send_iovs_[i].iov_len = pending.data.size();
+        std::memset(&send_msgs_[i], 0, sizeof(mmsghdr));
+        send_msgs_[i].msg_hdr.msg_name = pending.endpoint.data();
+        send_msgs_[i].msg_hdr.msg_namelen =
+            static_cast<socklen_t>(pending.endpoint.size());
+        send_msgs_[i].msg_hdr.msg_iov = &send_iovs_[i];
+        send_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    sent = sendBatch(send_msgs_.data(), pending_count_);
+#endif
+
+    // Whatever the batched path did not send goes out one datagram at a time
+    for (; sent < pending_count_; ++sent) {
+        try {
+            socket_->send_to(asio::buffer(pending_[sent].data),
+                            pending_[sent].endpoint);
+        } catch (const std::exception &e) {
+            std::cerr << "Error sending to " << endpointToString(pending_[sent].endpoint)
+                      << ": " << e.what() << std::endl;
+        }
+    }
+
+    pending_count_ = 0;
+}
+
+bool UDPServer::broadcast(const uint8_t *data, std::size_t size,
+                          uint32_t except_client) {
+    // One snapshot for the whole fan-out, no per-client lookups
+    UdpEndpointSnapshot endpoints = activeEndpoints();
+    std::size_t sent = 0;
+
+#ifdef __linux__
+    std::size_t count = 0;
+    iovec iov;
+    iov.iov_base = const_cast<uint8_t *>(data);
+    iov.iov_len = size;
+
+    broadcast_msgs_.resize(endpoints->size());
+    for (const auto &entry : *endpoints) {
+        if (entry.id == except_client) {
+            continue;
+        }
+        mmsghdr &msg = broadcast_msgs_[count++];
+        std::memset(&msg, 0, sizeof(mmsghdr));
+        msg.msg_hdr.msg_name =
+            const_cast<void *>(static_cast<const void *>(entry.endpoint.data()));
+        msg.msg_hdr.msg_namelen = static_cast<socklen_t>(entry.endpoint.size());
+        msg.msg_hdr.msg_iov = &iov;
+        msg.msg_hdr.msg_iovlen = 1;
+    }
+    sent = sendBatch(broadcast_msgs_.data(), count);
+#endif
+
+    bool ok = true;
+    std::size_t index = 0;
+    for (const auto &entry : *endpoints) {
+        if (entry.id == except_client) {
+            continue;
+        }
+        if (index++ < sent) {
+            continue;
+        }
+        try {
+            socket_->send_to(asio::buffer(data, size), entry.endpoint);
+        } catch (const std::exception &e) {
+            std::cerr << "Error sending to client " << entry.id << ": "
+                      << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+#ifdef __linux__
+std::size_t UDPServer::sendBatch(mmsghdr *msgs, std::size_t count) {
+    std::size_t sent = 0;
+
+    while (sent < count) {
+        int result = ::sendmmsg(socket_->native_handle(), msgs + sent,
+                                static_cast<unsigned int>(count - sent), 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[UDPServer] sendmmsg failed: " << std::strerror(errno)
+                      << std::endl;
+            break;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return sent;
+}
+#endif
+
 void UDPServer::disconnectClient(uint32_t client_id) {
     unregisterClient(client_id);
 }
@@ -122,7 +462,11 @@ void UDPServer::checkAndDisconnectInactiveClients(std::chrono::seconds timeout)
         auto it = clients_.find(client_id);
         if (it != clients_.end()) {
             it->second->is_active = false;
+            endpoint_index_.erase(makeEndpointKey(it->second->endpoint));
             clients_.erase(client_id);
         }
     }
+    if (!inactive_clients.empty()) {
+        rebuildEndpointSnapshot();
+    }
 }
@@ -0,0 +1,141 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** GameInstancePool.cpp
+*/
+
+#include "serverloop/GameInstancePool.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// std heap algorithms build a max-heap, invert to get the earliest deadline on top
+template <typename Slot>
+bool laterDeadline(const Slot &a, const Slot &b) {
+    return a.deadline > b.deadline;
+}
+
+} // namespace
+
+GameInstancePool::GameInstancePool(std::size_t worker_count)
+    : _running(true), _hosted(0), _next_worker(0) {
+    worker_count = std::max<std::size_t>(1, worker_count);
+    _workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // Started once every worker exists, any of them may be stolen from
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        _workers[i]->thread = std::thread(&GameInstancePool::workerLoop, this, i);
+    }
+}
+
+GameInstancePool::~GameInstancePool() { stop(); }
+
+void GameInstancePool::stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+
+    for (auto &worker : _workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    for (auto &worker : _workers) {
+        _hosted -= worker->heap.size();
+        worker->heap.clear();
+    }
+}
+
+void GameInstancePool::add(uint16_t instance_id, std::unique_ptr<GameServerLoop> game) {
+    if (!game) {
+        return;
+    }
+
+    clock::time_point deadline = game->nextTickDeadline();
+    std::size_t index = _next_worker++ % _workers.size();
+    ++_hosted;
+    push(*_workers[index], {deadline, instance_id, std::move(game)});
+}
+
+void GameInstancePool::collectFinished(std::vector<uint16_t> &out) {
+    std::lock_guard<std::mutex> lock(_finished_mutex);
+    out.insert(out.end(), _finished.begin(), _finished.end());
+    _finished.clear();
+}
+
+void GameInstancePool::workerLoop(std::size_t index) {
+    Worker &self = *_workers[index];
+    Slot slot;
+
+    while (_running) {
+        clock::time_point now = clock::now();
+
+        if (!takeDue(index, now, slot)) {
+            clock::time_point wake = now + IDLE_WAIT;
+            {
+                std::lock_guard<std::mutex> lock(self.mutex);
+                if (!self.heap.empty()) {
+                    wake = std::min(wake, self.heap.front().deadline);
+                }
+            }
+            std::this_thread::sleep_until(wake);
+            continue;
+        }
+
+        if (slot.game->tick()) {
+            slot.deadline = slot.game->nextTickDeadline();
+            push(self, std::move(slot));
+            continue;
+        }
+
+        uint16_t instance_id = slot.instance_id;
+        slot.game.reset();
+        --_hosted;
+        std::cout << "[GameInstancePool] Game instance " << instance_id
+                  << " finished" << std::endl;
+
+        std::lock_guard<std::mutex> lock(_finished_mutex);
+        _finished.push_back(instance_id);
+    }
+}
+
+bool GameInstancePool::takeDue(std::size_t index, clock::time_point now, Slot &out) {
+    {
+        std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+        if (popDue(*_workers[index], now, out)) {
+            return true;
+        }
+    }
+
+    // Nothing due here, help a worker that is behind. A busy victim is
+    // skipped rather than waited for.
+    for (std::size_t offset = 1; offset < _workers.size(); ++offset) {
+        Worker &victim = *_workers[(index + offset) % _workers.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (lock.owns_lock() && popDue(victim, now, out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameInstancePool::popDue(Worker &worker, clock::time_point now, Slot &out) {
+    if (worker.heap.empty() || worker.heap.front().deadline > now) {
+        return false;
+    }
+
+    std::pop_heap(worker.heap.begin(), worker.heap.end(), laterDeadline<Slot>);
+    out = std::move(worker.heap.back());
+    worker.heap.pop_back();
+    return true;
+}
+
+void GameInstancePool::push(Worker &worker, Slot slot) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.heap.push_back(std::move(slot));
+    std::push_heap(worker.heap.begin(), worker.heap.end(), laterDeadline<Slot>);
+}
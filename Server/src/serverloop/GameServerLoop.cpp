@@ -1,53 +1,50 @@
 #include "serverloop/GameServerLoop.hpp"
 #include "gamelogic/GameLogic.hpp"
+#include "network/CompactEntityCodec.hpp"
 #include "network/protocol/UdpMessageType.hpp"
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <memory>
-#include <set>
 #include <unordered_map>
 
-static EntityType entityTypeFromString(const std::string &type_str) {
-    static const std::unordered_map<std::string, EntityType> lookup = {
-        {"player", EntityType::PLAYER},
-        {"enemy", EntityType::ENEMY},
-        {"enemy_level2", EntityType::ENEMY_LEVEL2},
-        {"enemy_level2_spread", EntityType::ENEMY_LEVEL2_SPREAD},
-        {"enemy_kamikaze", EntityType::ENEMY_KAMIKAZE},
-        {"projectile", EntityType::PROJECTILE},
-        {"allied_projectile", EntityType::ALLIED_PROJECTILE},
-        {"boss", EntityType::BOSS},
-        {"boss_level2_part1", EntityType::BOSS_LEVEL2_PART1},
-        {"boss_level2_part2", EntityType::BOSS_LEVEL2_PART2},
-        {"boss_level2_part3", EntityType::BOSS_LEVEL2_PART3},
-        {"powerup_shield", EntityType::POWERUP_SHIELD},
-        {"powerup_spread", EntityType::POWERUP_SPREAD},
-        {"powerup_laser", EntityType::POWERUP_LASER},
-        {"powerup_companion", EntityType::POWERUP_COMPANION},
-        {"companion", EntityType::COMPANION},
-    };
-
-    auto it = lookup.find(type_str);
-    if (it != lookup.end()) {
-        return it->second;
-    }
-    return EntityType::ENEMY;
+GameServerLoop *GameServerLoop::instance = nullptr;
+
+namespace {
+
+// Per-message limits keeping each message within one FrameBuilder datagram
+const size_t MAX_SPAWNS_PER_MESSAGE = 40;           // 25 bytes each
+const size_t MAX_UPDATES_PER_MESSAGE = 45;          // 26 bytes each
+const size_t MAX_COMPACT_UPDATES_PER_MESSAGE = 64;  // 18 bytes at most
+const size_t MAX_DESTROYS_PER_MESSAGE = 256;        // 4 bytes each
+const size_t MAX_DEFERRED_PER_MESSAGE = 256;        // 4 bytes each
+
+bool isProjectile(EntityType type) {
+    return type == EntityType::PROJECTILE || type == EntityType::ALLIED_PROJECTILE;
 }
 
-GameServerLoop *GameServerLoop::instance = nullptr;
+} // namespace
 
-GameServerLoop::GameServerLoop(uint16_t port, uint32_t max_clients, uint8_t level_id)
-    : _port(port), _max_clients(max_clients), _level_id(level_id), _in_game(false),
+GameServerLoop::GameServerLoop(uint16_t port, uint32_t max_clients, uint8_t level_id,
+                               uint32_t tick_rate, uint32_t broadcast_rate)
+    : _port(port), _max_clients(max_clients), _level_id(level_id),
+      _tick_rate(TickScheduler::isSupportedRate(tick_rate) ? tick_rate : 60),
+      _broadcast_interval(1), _in_game(false),
       _victory_sent(false), _sequence_num(0), _running(false), _udp_server(nullptr),
-      _loop_thread(nullptr), _protocol() {
-    instance = this;
-    setupSignalHandlers();
+      _loop_thread(nullptr), _scheduler(_tick_rate), _protocol(), _relevancy(_tick_rate),
+      _reliable_resend_ticks(std::max<uint32_t>(1, _tick_rate / 5)) { // ~200 ms
+    if (broadcast_rate > 0 && broadcast_rate < _tick_rate) {
+        _broadcast_interval = _tick_rate / broadcast_rate;
+    }
 }
 
 GameServerLoop::~GameServerLoop() {
     stop();
-    instance = nullptr;
+    if (instance == this) {
+        instance = nullptr;
+    }
 }
 
 void GameServerLoop::setupSignalHandlers() {
@@ -68,6 +65,10 @@ void GameServerLoop::start() {
         return;
     }
 
+    // Only a game owning its process may take over the process signals
+    instance = this;
+    setupSignalHandlers();
+
     try {
         _udp_server = std::make_unique<UDPServer>(_port, _max_clients);
         _running = true;
@@ -78,6 +79,45 @@ void GameServerLoop::start() {
     }
 }
 
+bool GameServerLoop::startHosted(UDPServer *shared_port) {
+    if (_running) {
+        return true;
+    }
+
+    try {
+        _udp_server = shared_port ? std::make_unique<UDPServer>(*shared_port, _max_clients)
+                                  : std::make_unique<UDPServer>(_port, _max_clients);
+    } catch (const std::exception &e) {
+        std::cerr << "Failed to start GameServerLoop: " << e.what() << std::endl;
+        return false;
+    }
+    open();
+    _running = true;
+    return true;
+}
+
+void GameServerLoop::assign(uint32_t max_clients, uint8_t level_id) {
+    _max_clients = max_clients;
+    _level_id = level_id;
+    if (_udp_server) {
+        _udp_server->setMaxClients(max_clients);
+    }
+    if (_game_logic) {
+        _game_logic->setLevel(level_id);
+    }
+    _last_tick = std::chrono::steady_clock::now();
+    _scheduler.reset();
+}
+
+bool GameServerLoop::tick() {
+    if (!_running) {
+        return false;
+    }
+    _scheduler.tickStarted(TickScheduler::clock::now());
+    step();
+    return _running;
+}
+
 void GameServerLoop::stop() {
     if (!_running) {
         return;
@@ -94,59 +134,62 @@ void GameServerLoop::stop() {
 }
 
 void GameServerLoop::run() {
-    _game_logic = std::make_unique<GameLogic>(std::make_shared<registry>(), _level_id);
-    _last_tick = std::chrono::steady_clock::now();
+    open();
 
     while (_running) {
-        if (!_in_game && _udp_server->getCurrentClientCount() == _max_clients) {
-            _in_game = true;
-            _game_logic->start();
-            _last_tick = std::chrono::steady_clock::now();
-        }
+        _scheduler.waitForNextTick();
+        step();
+    }
+}
 
-        if (_in_game) {
-            // Check and disconnect inactive clients (10 seconds timeout)
-            _udp_server->checkAndDisconnectInactiveClients(std::chrono::seconds(10));
+void GameServerLoop::open() {
+    _game_logic = std::make_unique<GameLogic>(std::make_shared<registry>(), _level_id, _tick_rate);
+    _last_tick = std::chrono::steady_clock::now();
+    _scheduler.reset();
+}
 
-            // Check if all players have disconnected
-            if (_udp_server->getCurrentClientCount() == 0) {
-                _running = false;
-                break;
-            }
+void GameServerLoop::step() {
+    if (!_in_game && _udp_server->getCurrentClientCount() == _max_clients) {
+        _in_game = true;
+        _game_logic->start();
+        _last_tick = std::chrono::steady_clock::now();
+        _scheduler.reset();
+    }
 
-            processMessages();
+    if (_in_game) {
+        // Check and disconnect inactive clients (10 seconds timeout)
+        _udp_server->checkAndDisconnectInactiveClients(std::chrono::seconds(10));
 
-            auto now = std::chrono::steady_clock::now();
-            float delta = std::chrono::duration<float>(now - _last_tick).count();
+        // Check if all players have disconnected
+        if (_udp_server->getCurrentClientCount() == 0) {
+            _running = false;
+            return;
+        }
 
-            if (delta > 0.1f) {
-                delta = 0.1f;
-            }
+        processMessages();
 
-            _game_logic->update(delta);
-            _last_tick = now;
+        _game_logic->step();
+        _last_tick = std::chrono::steady_clock::now();
 
+        if (_game_logic->getCurrentTick() % _broadcast_interval == 0) {
             broadcastEntityUpdates();
+        }
 
-            if (_game_logic->isLevelComplete() && !_victory_sent) {
-                std::string victory_msg = _protocol.createVictory(_sequence_num++);
-                auto clients = _udp_server->getConnectedClients();
-                for (uint32_t client_id : clients) {
-                    _udp_server->sendToClient(client_id, victory_msg);
-                }
-                _victory_sent = true;
-            }
-        } else {
-            processMessages();
-
-            auto elapsed = std::chrono::steady_clock::now() - _last_tick;
-            if (std::chrono::duration<float>(elapsed).count() > 30.0f) {
-                _running = false;
-            }
+        if (_game_logic->isLevelComplete() && !_victory_sent) {
+            broadcastEvent(_protocol.createVictory(_sequence_num++));
+            _victory_sent = true;
         }
+    } else {
+        processMessages();
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        auto elapsed = std::chrono::steady_clock::now() - _last_tick;
+        if (std::chrono::duration<float>(elapsed).count() > 30.0f) {
+            _running = false;
+        }
     }
+
+    // Everything queued during this tick leaves in one batch
+    _udp_server->flush();
 }
 
 void GameServerLoop::processMessages() {
@@ -154,82 +197,254 @@ void GameServerLoop::processMessages() {
         return;
     }
 
-    auto messages = _udp_server->poll();
-
-    for (const auto &msg : messages) {
-        ParsedUdpMessage parsed = _protocol.parseMessage(msg.message);
+    // Messages are handled in place, straight out of the network inbox
+    _udp_server->drain([this](const UdpClientMessage &msg) { handleMessage(msg); });
+}
 
-        if (!parsed.valid) {
-            std::cerr << "Invalid UDP message from client " << msg.client_id << std::endl;
-            continue;
-        }
+void GameServerLoop::handleMessage(const UdpClientMessage &msg) {
+    // The view points into the inbox slot, valid until this call returns
+    UdpMessageView parsed = _protocol.parseMessageView(
+        reinterpret_cast<const uint8_t *>(msg.message.data()), msg.message.size());
 
-        if (parsed.type == CLIENT_PING) {
-            if (_game_logic->getPlayerEntity(msg.client_id) == entity(static_cast<size_t>(-1))) {
-                uint net_id = _game_logic->generateNetId();
+    if (!parsed.valid) {
+        std::cerr << "Invalid UDP message from client " << msg.client_id << std::endl;
+        return;
+    }
 
-                float spawn_x = 0.1f + (0.15f * (msg.client_id % 4));
-                float spawn_y = 0.4f + (0.1f * (msg.client_id % 4));
+    if (parsed.type == CLIENT_PING) {
+        _client_caps[msg.client_id] = UdpProtocole::parseClientCapabilities(parsed.data);
+
+        if (_game_logic->getPlayerEntity(msg.client_id) != entity(static_cast<size_t>(-1))) {
+            // A joined client pings again when PLAYER_ASSIGNMENT got lost. The
+            // tick does not advance before the game starts, resend right away.
+            if (ReliableChannel *channel = reliableChannel(msg.client_id)) {
+                channel->resendExpired(_game_logic->getCurrentTick(), 0,
+                                       [this, &msg](const std::string &message) {
+                                           _udp_server->queueToClient(msg.client_id, message);
+                                       });
+            }
+        } else {
+            uint net_id = _game_logic->generateNetId();
 
-                _game_logic->createPlayer(msg.client_id, net_id, spawn_x, spawn_y);
+            float spawn_x = 0.1f + (0.15f * (msg.client_id % 4));
+            float spawn_y = 0.4f + (0.1f * (msg.client_id % 4));
 
-                std::string assign_msg = _protocol.createPlayerAssignment(net_id, _sequence_num++);
-                _udp_server->sendToClient(msg.client_id, assign_msg);
+            _game_logic->createPlayer(msg.client_id, net_id, spawn_x, spawn_y);
+            _acked_ticks[msg.client_id] = 0;
+            _input_sequences[msg.client_id] = 0;
+            if (clientHasCapability(msg.client_id, network::CAP_RELIABLE_EVENTS)) {
+                _reliable[msg.client_id] = ReliableChannel();
+            }
 
-                auto snapshot = _game_logic->generateSnapshot();
-                std::vector<Entity> entities;
+            FrameBuilder &join_frame = _frames[msg.client_id];
+            join_frame.reset(clientHasCapability(msg.client_id, network::CAP_AGGREGATED_DATAGRAMS));
+            appendEvent(msg.client_id, join_frame,
+                        _protocol.createPlayerAssignment(
+                            net_id, static_cast<uint8_t>(_tick_rate), _sequence_num++));
 
-                for (const auto &snap : snapshot.entities) {
-                    EntityType type = entityTypeFromString(snap.entity_type);
+            auto snapshot = _game_logic->generateSnapshot();
+            std::vector<Entity> entities;
+            bool simulates_projectiles = simulatesProjectiles(msg.client_id);
 
-                    entities.push_back({snap.net_id, type,
-                                        static_cast<uint32_t>(snap.health),
-                                        static_cast<uint32_t>(snap.shield),
-                                        snap.pos.x, snap.pos.y,
-                                        static_cast<uint32_t>(snap.score)});
+            for (const auto &snap : snapshot.entities) {
+                EntityType type = snap.entity_type;
+                if (simulates_projectiles && isProjectile(type)) {
+                    continue;
                 }
 
-                std::string game_state_msg = _protocol.createGameState(entities, _sequence_num++);
-                _udp_server->sendToClient(msg.client_id, game_state_msg);
+                entities.push_back({snap.net_id, type,
+                                    static_cast<uint32_t>(snap.health),
+                                    static_cast<uint32_t>(snap.shield),
+                                    snap.pos.x, snap.pos.y,
+                                    static_cast<uint32_t>(snap.score)});
+            }
 
-                Entity new_player_entity = {net_id, EntityType::PLAYER, 100, 0, spawn_x, spawn_y, 0};
-                std::string create_msg = _protocol.createEntityCreate(new_player_entity, _sequence_num++);
+            appendEvent(msg.client_id, join_frame,
+                        _protocol.createGameState(entities, _sequence_num++));
 
-                auto all_clients = _udp_server->getConnectedClients();
-                for (uint32_t client_id : all_clients) {
-                    if (client_id != msg.client_id) {
-                        _udp_server->sendToClient(client_id, create_msg);
-                    }
+            if (simulates_projectiles) {
+                _game_logic->getLiveProjectiles(_new_projectiles);
+                buildProjectileSpawns(_new_projectiles);
+                for (size_t i = 0; i < _spawn_message_count; ++i) {
+                    appendEvent(msg.client_id, join_frame, _spawn_messages[i]);
                 }
             }
-        } else if (parsed.type == PLAYER_INPUT && parsed.data.size() >= 2) {
-            uint8_t event_type = parsed.data[0];
-            uint8_t direction = parsed.data[1];
-
-            if (event_type == 0x01) {
-                _game_logic->pushClientEvent({msg.client_id, KEY_UP_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
-                _game_logic->pushClientEvent({msg.client_id, KEY_DOWN_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
-                _game_logic->pushClientEvent({msg.client_id, KEY_LEFT_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
-                _game_logic->pushClientEvent({msg.client_id, KEY_RIGHT_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
-
-                if (direction & 0x01) {
-                    _game_logic->pushClientEvent({msg.client_id, KEY_UP_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
-                }
-                if (direction & 0x02) {
-                    _game_logic->pushClientEvent({msg.client_id, KEY_DOWN_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
-                }
-                if (direction & 0x04) {
-                    _game_logic->pushClientEvent({msg.client_id, KEY_LEFT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
-                }
-                if (direction & 0x08) {
-                    _game_logic->pushClientEvent({msg.client_id, KEY_RIGHT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
-                }
-            } else if (event_type == 0x02) {
-                _game_logic->pushClientEvent({msg.client_id, KEY_SHOOT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
-            } else if (event_type == 0x03) {
-                _game_logic->removePlayer(msg.client_id);
-                _udp_server->disconnectClient(msg.client_id);
+            sendFrame(msg.client_id, join_frame);
+
+            Entity new_player_entity = {net_id, EntityType::PLAYER, 100, 0, spawn_x, spawn_y, 0};
+            _protocol.createEntityCreate(new_player_entity, _sequence_num++, _message);
+            broadcastEvent(_message, msg.client_id);
+        }
+    } else if (parsed.type == PLAYER_INPUT && parsed.data.size() >= 2) {
+        uint8_t event_type = parsed.data[0];
+        uint8_t direction = parsed.data[1];
+
+        if (event_type == 0x01) {
+            _game_logic->pushClientEvent({msg.client_id, KEY_UP_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
+            _game_logic->pushClientEvent({msg.client_id, KEY_DOWN_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
+            _game_logic->pushClientEvent({msg.client_id, KEY_LEFT_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
+            _game_logic->pushClientEvent({msg.client_id, KEY_RIGHT_RELEASE, parsed.sequence_num, std::chrono::steady_clock::now()});
+
+            if (direction & 0x01) {
+                _game_logic->pushClientEvent({msg.client_id, KEY_UP_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
+            }
+            if (direction & 0x02) {
+                _game_logic->pushClientEvent({msg.client_id, KEY_DOWN_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
             }
+            if (direction & 0x04) {
+                _game_logic->pushClientEvent({msg.client_id, KEY_LEFT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
+            }
+            if (direction & 0x08) {
+                _game_logic->pushClientEvent({msg.client_id, KEY_RIGHT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
+            }
+        } else if (event_type == 0x02) {
+            _game_logic->pushClientEvent({msg.client_id, KEY_SHOOT_PRESS, parsed.sequence_num, std::chrono::steady_clock::now()});
+        } else if (event_type == 0x03) {
+            _game_logic->removePlayer(msg.client_id);
+            _udp_server->disconnectClient(msg.client_id);
+            _acked_ticks.erase(msg.client_id);
+            _input_sequences.erase(msg.client_id);
+            _client_caps.erase(msg.client_id);
+            _frames.erase(msg.client_id);
+            _relevancy.removeClient(msg.client_id);
+            _reliable.erase(msg.client_id);
+        }
+    } else if (parsed.type == INPUT_STATE) {
+        std::array<InputFrame, INPUT_STATE_MAX_FRAMES> frames;
+        size_t count = UdpProtocole::parseInputState(parsed.data, frames.data(), frames.size());
+        uint32_t &last_sequence = _input_sequences[msg.client_id];
+
+        // Every packet repeats the last few frames, drop duplicates and reordered ones
+        if (count == 0 || frames[0].sequence <= last_sequence) {
+            return;
+        }
+
+        // A shot in any frame not seen yet still fires, even if its own packet was lost
+        bool fire = false;
+        for (size_t i = 0; i < count && frames[i].sequence > last_sequence; ++i) {
+            if (frames[i].buttons & network::INPUT_SHOOT) {
+                fire = true;
+            }
+        }
+
+        _game_logic->applyInputState(msg.client_id, frames[0].buttons, fire);
+        last_sequence = frames[0].sequence;
+    } else if (parsed.type == SNAPSHOT_ACK) {
+        uint32_t tick = UdpProtocole::parseSnapshotAck(parsed.data);
+        uint32_t &acked = _acked_ticks[msg.client_id];
+
+        // Acks can arrive out of order, only ever move the baseline forward
+        if (tick > acked && tick <= _game_logic->getCurrentTick()) {
+            acked = tick;
+        }
+
+        uint32_t delivered;
+        uint32_t received_bits;
+        ReliableChannel *channel = reliableChannel(msg.client_id);
+        if (channel && UdpProtocole::parseReliableAck(parsed.data, delivered, received_bits)) {
+            channel->acknowledge(delivered, received_bits);
+        }
+    }
+}
+
+bool GameServerLoop::clientHasCapability(uint32_t client_id, uint8_t capability) const {
+    auto it = _client_caps.find(client_id);
+    return it != _client_caps.end() && (it->second & capability);
+}
+
+// Projectiles leave the deltas of these clients, so their spawn must not be
+// lost: it goes through the reliable channel, which the client needs too
+bool GameServerLoop::simulatesProjectiles(uint32_t client_id) const {
+    return clientHasCapability(client_id, network::CAP_PROJECTILE_SPAWN) &&
+           _reliable.count(client_id) > 0;
+}
+
+void GameServerLoop::buildProjectileSpawns(const std::vector<GameLogic::NewEntityInfo> &projectiles) {
+    uint32_t server_tick = _game_logic->getCurrentTick();
+    _spawn_message_count = 0;
+
+    for (size_t first = 0; first < projectiles.size(); first += MAX_SPAWNS_PER_MESSAGE) {
+        size_t last = std::min(projectiles.size(), first + MAX_SPAWNS_PER_MESSAGE);
+
+        _projectile_spawns.clear();
+        for (size_t i = first; i < last; ++i) {
+            const auto &proj = projectiles[i];
+            _projectile_spawns.push_back({proj.net_id, proj.entity_type,
+                                          proj.spawn_tick, proj.x, proj.y, proj.vx, proj.vy});
+        }
+
+        // Message buffers are reused across ticks, only grow the list
+        if (_spawn_message_count == _spawn_messages.size()) {
+            _spawn_messages.emplace_back();
+        }
+        _protocol.createProjectileSpawn(server_tick, static_cast<uint8_t>(_tick_rate),
+                                        _projectile_spawns.data(), _projectile_spawns.size(),
+                                        _sequence_num++, _spawn_messages[_spawn_message_count++]);
+    }
+}
+
+void GameServerLoop::appendEntityUpdates(FrameBuilder &frame, uint32_t tick, bool compact) {
+    const size_t max_per_message = compact ? MAX_COMPACT_UPDATES_PER_MESSAGE : MAX_UPDATES_PER_MESSAGE;
+
+    // An empty update is still sent so the client keeps acking ticks. The
+    // client only acks once every chunk arrived, the relevancy budget keeps
+    // their count far below 255.
+    size_t chunks = std::max<size_t>(
+        1, (_update_entities.size() + max_per_message - 1) / max_per_message);
+    for (size_t index = 0; index < chunks; ++index) {
+        size_t first = index * max_per_message;
+        size_t last = std::min(_update_entities.size(), first + max_per_message);
+        const Entity *chunk = _update_entities.data() + first;
+
+        if (compact) {
+            _protocol.createEntityUpdateCompact(tick, static_cast<uint8_t>(index),
+                                                static_cast<uint8_t>(chunks), chunk,
+                                                last - first, _sequence_num++, _message);
+        } else {
+            _protocol.createEntityUpdate(tick, static_cast<uint8_t>(index),
+                                         static_cast<uint8_t>(chunks), chunk, last - first,
+                                         _sequence_num++, _message);
+        }
+        frame.append(_message);
+    }
+}
+
+void GameServerLoop::sendFrame(uint32_t client_id, const FrameBuilder &frame) {
+    for (size_t i = 0; i < frame.size(); ++i) {
+        _udp_server->queueToClient(client_id, frame.datagram(i));
+    }
+}
+
+ReliableChannel *GameServerLoop::reliableChannel(uint32_t client_id) {
+    auto it = _reliable.find(client_id);
+    return it != _reliable.end() ? &it->second : nullptr;
+}
+
+void GameServerLoop::appendEvent(uint32_t client_id, FrameBuilder &frame,
+                                 const std::string &message) {
+    ReliableChannel *channel = reliableChannel(client_id);
+    frame.append(channel ? channel->send(message, _game_logic->getCurrentTick()) : message);
+}
+
+void GameServerLoop::queueEvent(uint32_t client_id, const std::string &message) {
+    ReliableChannel *channel = reliableChannel(client_id);
+    _udp_server->queueToClient(client_id,
+                               channel ? channel->send(message, _game_logic->getCurrentTick())
+                                       : message);
+}
+
+void GameServerLoop::broadcastEvent(const std::string &message, uint32_t except_client) {
+    // Without reliable channels every client gets the same bytes, fanned out at once
+    if (_reliable.empty()) {
+        _udp_server->broadcast(reinterpret_cast<const uint8_t *>(message.data()),
+                               message.size(), except_client);
+        return;
+    }
+
+    _udp_server->collectConnectedClients(_clients);
+    for (uint32_t client_id : _clients) {
+        if (client_id != except_client) {
+            queueEvent(client_id, message);
         }
     }
 }
@@ -239,65 +454,135 @@ void GameServerLoop::broadcastEntityUpdates() {
         return;
     }
 
-    auto clients = _udp_server->getConnectedClients();
-    if (clients.empty()) {
+    _udp_server->collectConnectedClients(_clients);
+    if (_clients.empty()) {
         return;
     }
+    const std::vector<uint32_t> &clients = _clients;
+
+    // Everything sent to a client this tick is packed into as few datagrams as possible
+    uint32_t now = _game_logic->getCurrentTick();
+    for (uint32_t client_id : clients) {
+        FrameBuilder &frame = _frames[client_id];
+        frame.reset(clientHasCapability(client_id, network::CAP_AGGREGATED_DATAGRAMS));
+
+        // Events still unacknowledged go out again ahead of this tick's own
+        if (ReliableChannel *channel = reliableChannel(client_id)) {
+            channel->resendExpired(now, _reliable_resend_ticks,
+                                   [&frame](const std::string &message) { frame.append(message); });
+        }
+    }
 
-    auto new_entities = _game_logic->getNewEntities();
-    std::set<uint> new_entity_ids;
-
-    for (const auto &new_ent : new_entities) {
-        new_entity_ids.insert(new_ent.net_id);
+    _game_logic->getNewEntities(_new_entities);
+    _new_projectiles.clear();
 
-        EntityType type = entityTypeFromString(new_ent.entity_type);
+    for (const auto &new_ent : _new_entities) {
+        EntityType type = new_ent.entity_type;
+        bool projectile = isProjectile(type);
+        if (projectile) {
+            _new_projectiles.push_back(new_ent);
+        }
 
         Entity ent = {new_ent.net_id, type, static_cast<uint32_t>(new_ent.health),
                       static_cast<uint32_t>(new_ent.shield), new_ent.x, new_ent.y, 0};
-        std::string create_msg = _protocol.createEntityCreate(ent, _sequence_num++);
+        _protocol.createEntityCreate(ent, _sequence_num++, _message);
+
+        for (uint32_t client_id : clients) {
+            // These clients get the projectile through PROJECTILE_SPAWN below
+            if (projectile && simulatesProjectiles(client_id)) {
+                continue;
+            }
+            appendEvent(client_id, _frames[client_id], _message);
+        }
+    }
 
+    if (!_new_projectiles.empty()) {
+        buildProjectileSpawns(_new_projectiles);
         for (uint32_t client_id : clients) {
-            _udp_server->sendToClient(client_id, create_msg);
+            if (!simulatesProjectiles(client_id)) {
+                continue;
+            }
+            for (size_t i = 0; i < _spawn_message_count; ++i) {
+                appendEvent(client_id, _frames[client_id], _spawn_messages[i]);
+            }
         }
     }
 
-    auto deltas = _game_logic->getDeltaSnapshot(0);
+    // Each client gets the changes since the last snapshot it acked. New
+    // entities are included too, so a lost ENTITY_CREATE is recovered here.
+    uint32_t tick = _game_logic->captureSnapshot();
+
+    for (uint32_t client_id : clients) {
+        auto acked_it = _acked_ticks.find(client_id);
+        uint32_t baseline = acked_it != _acked_ticks.end() ? acked_it->second : 0;
+
+        _game_logic->getDeltaSnapshot(baseline, _delta_states);
 
-    std::vector<Entity> entities;
-    for (const auto &snap : deltas) {
-        if (new_entity_ids.count(snap.net_id) > 0) {
-            continue;
+        // Projectiles are simulated by clients that received PROJECTILE_SPAWN
+        if (simulatesProjectiles(client_id)) {
+            _delta_states.erase(std::remove_if(_delta_states.begin(), _delta_states.end(),
+                                               [](const EntityState &state) {
+                                                   return isProjectile(state.type);
+                                               }),
+                                _delta_states.end());
         }
 
-        EntityType type = entityTypeFromString(snap.entity_type);
-
-        Entity ent_data;
-        ent_data.net_id = snap.net_id;
-        ent_data.type = type;
-        ent_data.health = static_cast<uint32_t>(snap.health);
-        ent_data.shield = static_cast<uint32_t>(snap.shield);
-        ent_data.position_x = snap.pos.x;
-        ent_data.position_y = snap.pos.y;
-        ent_data.score = static_cast<uint32_t>(snap.score);
-        ent_data.flags = snap.beam_active ? 0x01 : 0x00;
-        entities.push_back(ent_data);
-    }
+        // Keeps what matters to this client within its byte budget
+        bool compact = clientHasCapability(client_id, network::CAP_COMPACT_UPDATES);
+        Position viewer;
+        bool has_viewer = _game_logic->getPlayerPosition(client_id, viewer);
+        _relevancy.select(client_id, tick, baseline, has_viewer ? &viewer : nullptr,
+                          _delta_states, _game_logic->getLatestSnapshot(), compact,
+                          _relevant_states, _deferred);
+
+        _update_entities.clear();
+        for (const EntityState &state : _relevant_states) {
+            Entity ent_data;
+            ent_data.net_id = state.net_id;
+            ent_data.type = state.type;
+            ent_data.health = static_cast<uint32_t>(state.health);
+            ent_data.shield = static_cast<uint32_t>(state.shield);
+            ent_data.position_x = state.x;
+            ent_data.position_y = state.y;
+            ent_data.score = static_cast<uint32_t>(state.score);
+            ent_data.flags = state.flags;
+            ent_data.fields = state.fields;
+            _update_entities.push_back(ent_data);
+        }
 
-    if (!entities.empty()) {
-        std::string update_msg = _protocol.createEntityUpdate(entities, _sequence_num++);
+        // Tells a predicting client which of its inputs this snapshot includes
+        auto input_it = _input_sequences.find(client_id);
+        if (input_it != _input_sequences.end() && input_it->second > 0) {
+            _protocol.createInputAck(tick, input_it->second, _sequence_num++, _message);
+            _frames[client_id].append(_message);
+        }
 
-        for (uint32_t client_id : clients) {
-            _udp_server->sendToClient(client_id, update_msg);
+        // Tells the client which missing entities moved but were held back
+        if (clientHasCapability(client_id, network::CAP_DEFERRED_UPDATES)) {
+            for (size_t first = 0; first < _deferred.size(); first += MAX_DEFERRED_PER_MESSAGE) {
+                size_t last = std::min(_deferred.size(), first + MAX_DEFERRED_PER_MESSAGE);
+                _protocol.createEntityDeferred(tick, _deferred.data() + first, last - first,
+                                               _sequence_num++, _message);
+                _frames[client_id].append(_message);
+            }
         }
+
+        appendEntityUpdates(_frames[client_id], tick, compact);
     }
 
     _game_logic->markEntitiesSynced();
 
-    auto destroyed = _game_logic->getDestroyedEntities();
-    if (!destroyed.empty()) {
-        std::string destroy_msg = _protocol.createEntityDestroy(destroyed, _sequence_num++);
+    _game_logic->getDestroyedEntities(_destroyed);
+    for (size_t first = 0; first < _destroyed.size(); first += MAX_DESTROYS_PER_MESSAGE) {
+        size_t last = std::min(_destroyed.size(), first + MAX_DESTROYS_PER_MESSAGE);
+        _protocol.createEntityDestroy(_destroyed.data() + first, last - first,
+                                      _sequence_num++, _message);
         for (uint32_t client_id : clients) {
-            _udp_server->sendToClient(client_id, destroy_msg);
+            appendEvent(client_id, _frames[client_id], _message);
         }
     }
+
+    for (uint32_t client_id : clients) {
+        sendFrame(client_id, _frames[client_id]);
+    }
 }
@@ -0,0 +1,205 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** RelevancyFilter.cpp
+*/
+
+#include "serverloop/RelevancyFilter.hpp"
+#include "network/CompactEntityCodec.hpp"
+#include <algorithm>
+
+namespace {
+
+// Weights of entities that do not need every broadcast
+const float FAR_ENEMY_WEIGHT = 0.5f;
+const float FAR_SHOT_WEIGHT = 0.25f;
+
+const EntityState *findState(const std::vector<EntityState> &states, uint32_t net_id) {
+    auto it = std::lower_bound(
+        states.begin(), states.end(), net_id,
+        [](const EntityState &s, uint32_t id) { return s.net_id < id; });
+    return (it != states.end() && it->net_id == net_id) ? &*it : nullptr;
+}
+
+} // namespace
+
+RelevancyFilter::RelevancyFilter(uint32_t tick_rate)
+    : _lag_limit(std::max<uint32_t>(1, tick_rate / 2)) {}
+
+void RelevancyFilter::select(uint32_t client_id, uint32_t tick, uint32_t acked_tick,
+                             const Position *viewer,
+                             const std::vector<EntityState> &delta,
+                             const std::vector<EntityState> &current, bool compact,
+                             std::vector<EntityState> &out,
+                             std::vector<uint32_t> &deferred) {
+    ClientRelevancy &client = _clients[client_id];
+    adaptBudget(client, tick, acked_tick);
+
+    // Pending fields resent in a snapshot the client has now acked are delivered
+    for (auto it = client.entities.begin(); it != client.entities.end();) {
+        EntityRelevancy &entry = it->second;
+        if (entry.sent_tick != 0 && acked_tick >= entry.sent_tick) {
+            entry.pending = 0;
+        }
+        if (entry.pending == 0) {
+            it = client.entities.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    _candidates.clear();
+    for (const EntityState &state : delta) {
+        consider(client, tick, viewer, state, state.fields);
+    }
+
+    // Entities still owing fields that did not change again since the baseline
+    for (auto it = client.entities.begin(); it != client.entities.end();) {
+        if (it->second.seen_tick == tick) {
+            ++it;
+            continue;
+        }
+        const EntityState *state = findState(current, it->first);
+        if (!state) {
+            // Destroyed, its ENTITY_DESTROY supersedes any pending field
+            it = client.entities.erase(it);
+            continue;
+        }
+        consider(client, tick, viewer, *state, 0);
+        ++it;
+    }
+
+    std::sort(_candidates.begin(), _candidates.end(),
+              [](const Candidate &a, const Candidate &b) { return a.priority > b.priority; });
+
+    out.clear();
+    size_t used = 0;
+    for (const Candidate &candidate : _candidates) {
+        uint32_t net_id = candidate.state->net_id;
+        auto it = client.entities.find(net_id);
+        size_t size = encodedSize(*candidate.state, candidate.fields, compact);
+
+        if (used + size > client.budget) {
+            // Keeps its accumulated priority, so it ranks higher next time
+            EntityRelevancy &entry = it != client.entities.end() ? it->second
+                                                                 : client.entities[net_id];
+            entry.priority = candidate.priority;
+            entry.pending |= candidate.fields;
+            entry.sent_tick = 0;
+            entry.seen_tick = tick;
+            continue;
+        }
+
+        used += size;
+        out.push_back(*candidate.state);
+        out.back().fields = candidate.fields;
+
+        if (it != client.entities.end()) {
+            it->second.priority = 0.0f;
+            it->second.sent_tick = tick;
+        }
+    }
+
+    std::sort(out.begin(), out.end(),
+              [](const EntityState &a, const EntityState &b) { return a.net_id < b.net_id; });
+
+    deferred.clear();
+    for (const auto &[net_id, entry] : client.entities) {
+        if (entry.sent_tick == 0 && (entry.pending & network::FIELD_POSITION)) {
+            deferred.push_back(net_id);
+        }
+    }
+    std::sort(deferred.begin(), deferred.end());
+}
+
+void RelevancyFilter::removeClient(uint32_t client_id) { _clients.erase(client_id); }
+
+void RelevancyFilter::adaptBudget(ClientRelevancy &client, uint32_t tick,
+                                  uint32_t acked_tick) const {
+    if (acked_tick == 0 || acked_tick > tick) {
+        return;
+    }
+
+    uint32_t lag = tick - acked_tick;
+    if (lag <= _lag_limit) {
+        client.budget = std::min(MAX_BUDGET, client.budget + BUDGET_STEP);
+    } else if (tick - client.last_cut_tick >= _lag_limit) {
+        // At most one cut per lag limit, the previous one needs time to show
+        client.budget = std::max(MIN_BUDGET, client.budget / 2);
+        client.last_cut_tick = tick;
+    }
+}
+
+void RelevancyFilter::consider(ClientRelevancy &client, uint32_t tick,
+                               const Position *viewer, const EntityState &state,
+                               uint8_t fields) {
+    float priority = weight(state, viewer);
+
+    auto it = client.entities.find(state.net_id);
+    if (it != client.entities.end()) {
+        fields |= it->second.pending;
+        priority += it->second.priority;
+        it->second.seen_tick = tick;
+    }
+
+    if (priority >= 1.0f) {
+        _candidates.push_back({&state, fields, priority});
+        return;
+    }
+
+    EntityRelevancy &entry = it != client.entities.end() ? it->second
+                                                         : client.entities[state.net_id];
+    entry.priority = priority;
+    entry.pending |= fields;
+    entry.sent_tick = 0;
+    entry.seen_tick = tick;
+}
+
+float RelevancyFilter::weight(const EntityState &state, const Position *viewer) {
+    bool near = false;
+    if (viewer) {
+        float dx = state.x - viewer->x;
+        float dy = state.y - viewer->y;
+        near = dx * dx + dy * dy <= NEAR_RADIUS * NEAR_RADIUS;
+    }
+
+    switch (state.type) {
+    case EntityType::PROJECTILE:
+        return near ? 1.0f : FAR_SHOT_WEIGHT;
+    case EntityType::ALLIED_PROJECTILE:
+        return FAR_SHOT_WEIGHT;
+    case EntityType::ENEMY:
+    case EntityType::ENEMY_LEVEL2:
+    case EntityType::ENEMY_LEVEL2_SPREAD:
+    case EntityType::ENEMY_KAMIKAZE:
+        return near ? 1.0f : FAR_ENEMY_WEIGHT;
+    default:
+        // Players, companions, boss parts and power-ups
+        return 1.0f;
+    }
+}
+
+size_t RelevancyFilter::encodedSize(const EntityState &state, uint8_t fields, bool compact) {
+    if (!compact) {
+        return ENTITY_UPDATE_SIZE;
+    }
+
+    // Mirrors network::compact::encode, with a 2-byte net_id delta and a
+    // full 5-byte score varint
+    using namespace network::compact;
+    size_t bits = 16 + TYPE_BITS + FIELD_BITS;
+    if (fields & network::FIELD_POSITION)
+        bits += 2 * POSITION_BITS;
+    if (fields & network::FIELD_HEALTH)
+        bits += HEALTH_BITS;
+    if (fields & network::FIELD_FLAGS)
+        bits += FLAG_BITS;
+    if (state.type == PLAYER_TYPE) {
+        if (fields & network::FIELD_SHIELD)
+            bits += SHIELD_BITS;
+        if (fields & network::FIELD_SCORE)
+            bits += 40;
+    }
+    return (bits + 7) / 8;
+}
@@ -0,0 +1,96 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** TickScheduler.cpp
+*/
+
+#include "serverloop/TickScheduler.hpp"
+#include <iostream>
+#include <thread>
+
+TickScheduler::TickScheduler(uint32_t tick_rate)
+    : _tick_rate(isSupportedRate(tick_rate) ? tick_rate : 60),
+      _period(std::chrono::duration_cast<clock::duration>(
+          std::chrono::duration<double>(1.0 / _tick_rate))),
+      _total_overruns(0), _overruns(0), _resyncs(0), _worst_overrun(0) {
+    if (_tick_rate != tick_rate) {
+        std::cerr << "[TickScheduler] Unsupported tick rate " << tick_rate
+                  << " Hz, using " << _tick_rate << " Hz" << std::endl;
+    }
+    reset();
+}
+
+bool TickScheduler::isSupportedRate(uint32_t tick_rate) {
+    return tick_rate == 30 || tick_rate == 60 || tick_rate == 120;
+}
+
+void TickScheduler::reset() {
+    _deadline = clock::now() + _period;
+    _last_report = clock::now();
+}
+
+void TickScheduler::waitForNextTick() {
+    auto now = clock::now();
+
+    if (now < _deadline) {
+        if (_deadline - now > SPIN_MARGIN) {
+            std::this_thread::sleep_until(_deadline - SPIN_MARGIN);
+        }
+        while (clock::now() < _deadline) {
+            std::this_thread::yield();
+        }
+        _deadline += _period;
+    } else {
+        recordOverrun(now);
+    }
+
+    reportOverruns(now);
+}
+
+void TickScheduler::tickStarted(clock::time_point now) {
+    // Plain sleeps wake up a little past the deadline, that is not an overrun
+    if (now <= _deadline + SPIN_MARGIN) {
+        _deadline += _period;
+    } else {
+        recordOverrun(now);
+    }
+
+    reportOverruns(now);
+}
+
+void TickScheduler::recordOverrun(clock::time_point now) {
+    auto late = now - _deadline;
+    _overruns++;
+    _total_overruns++;
+    if (late > _worst_overrun) {
+        _worst_overrun = late;
+    }
+
+    // Too far behind: drop the missed ticks rather than bursting them
+    if (late > _period * MAX_LATE_TICKS) {
+        _resyncs++;
+        _deadline = now + _period;
+    } else {
+        _deadline += _period;
+    }
+}
+
+void TickScheduler::reportOverruns(clock::time_point now) {
+    if (now - _last_report < REPORT_INTERVAL) {
+        return;
+    }
+
+    if (_overruns > 0) {
+        float worst_ms = std::chrono::duration<float, std::milli>(_worst_overrun).count();
+        std::cerr << "[TickScheduler] " << _overruns << " overrun(s) at "
+                  << _tick_rate << " Hz in the last " << REPORT_INTERVAL.count()
+                  << "s, worst +" << worst_ms << " ms, " << _resyncs
+                  << " resync(s)" << std::endl;
+    }
+
+    _overruns = 0;
+    _resyncs = 0;
+    _worst_overrun = clock::duration::zero();
+    _last_report = now;
+}
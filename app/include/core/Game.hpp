@@ -156,6 +156,8 @@ class Game {
     float _powerupSpawnTimer = 0.f;     ///< Timer for powerup spawning
     float _powerupSpawnInterval = 10.f; ///< Interval between powerup spawns
     float _gameTime = 0.f;              ///< Total game time elapsed
+    float _scriptStatsTimer = 0.f;      ///< Time since last Lua stats dump
+    float _scriptStatsInterval = 10.f;  ///< Interval between Lua stats dumps
 
     // Boss wave spawn system
     float _bossWaveTimer = 0.f;    ///< Timer for boss wave spawning
@@ -8,6 +8,8 @@
 #include "game/EnemyManager.hpp"
 #include "game/PlayerManager.hpp"
 #include "PacketProcessor.hpp"
+#include <array>
+#include <bitset>
 #include <atomic>
 #include <mutex>
 #include <optional>
@@ -86,6 +88,48 @@ class NetworkCommandHandler : public network::INetworkCommandHandler {
         return result;
     }
 
+    /**
+     * @brief Move projectiles received through PROJECTILE_SPAWN
+     *
+     * Positions are recomputed from the spawn origin and velocity so they
+     * do not drift. Projectiles leaving the screen or outliving their server
+     * lifetime are removed locally.
+     * @param dt Frame time in seconds
+     */
+    void updateSimulatedProjectiles(float dt);
+
+    /**
+     * @brief Move the local player right away from a sampled input frame
+     *
+     * The frame is kept until an INPUT_ACK covers it and replayed on top of
+     * every authoritative position received before then.
+     * @param input_sequence Sequence sent in INPUT_STATE
+     * @param buttons network::InputButton bits
+     * @param dt Seconds the buttons are held for
+     */
+    void predictLocalPlayer(uint32_t input_sequence, uint8_t buttons, float dt);
+
+    /**
+     * @brief Set the local time received snapshots arrive at
+     *
+     * Packets are only processed on game ticks, so this is the tick clock.
+     * Arrival times only feed the clock offset and jitter estimates.
+     * @param now Seconds, same clock as interpolateRemoteEntities()
+     */
+    void setNetworkTime(double now) { network_time_ = now; }
+
+    /**
+     * @brief Place remote entities between their buffered server positions
+     *
+     * Samples are stamped with the server time of their snapshot. The render
+     * time is mapped onto it with the smoothed clock offset, then moved
+     * playout_delay_ seconds into the past, which is tuned from the measured
+     * snapshot jitter. Past the newest sample, entities
+     * keep their last velocity for a short while and then hold.
+     * @param render_time Tick clock plus the interpolation factor
+     */
+    void interpolateRemoteEntities(double render_time);
+
   private:
     entity createPlayerEntity(const network::CreateEntityCommand &cmd);
     entity createEnemyEntity(const network::CreateEntityCommand &cmd);
@@ -107,6 +151,72 @@ class NetworkCommandHandler : public network::INetworkCommandHandler {
     entity createPowerUpCompanionEntity(const network::CreateEntityCommand &cmd);
     entity createActiveCompanionEntity(const network::CreateEntityCommand &cmd);
 
+    /**
+     * @brief Apply a decoded ENTITY_UPDATE / ENTITY_UPDATE_COMPACT
+     * @param payload Message payload, read for its snapshot tick and chunk;
+     *                stale ticks are dropped
+     * @param updates Decoded entity states
+     */
+    void applyEntityUpdates(const std::vector<uint8_t> &payload,
+                            const std::vector<network::EntityUpdateData> &updates);
+
+    /**
+     * @brief Give the entities a snapshot left out a sample at their last
+     * position, once that snapshot is complete
+     *
+     * Skipped for the entities the server held back (ENTITY_DEFERRED), which
+     * moved, and for every entity if a chunk of the snapshot was lost.
+     */
+    void repeatUnchangedSamples(uint32_t snapshot_tick);
+
+    /**
+     * @brief Create and start simulating the projectiles of a PROJECTILE_SPAWN
+     * @param batch Decoded message
+     */
+    void spawnSimulatedProjectiles(const network::ProjectileSpawnBatch &batch);
+
+    /**
+     * @brief Rebase the local prediction on a server position
+     * @param x Server position, replaced by the position with the
+     *          unacknowledged inputs replayed on top
+     * @param y Same as x
+     * @return false if the position should be ignored, i.e. no INPUT_ACK
+     *         tells which inputs it includes
+     */
+    bool reconcileLocalPlayer(float &x, float &y);
+
+    /**
+     * @brief Server time of a snapshot in seconds, the timeline of the samples
+     */
+    double snapshotTime(uint32_t snapshot_tick) const;
+
+    /**
+     * @brief Update the clock offset, interval and jitter estimates on arrival
+     * @param server_time snapshotTime() of the new snapshot
+     * @param arrival_time Local time it was received at
+     */
+    void updatePlayoutDelay(double server_time, double arrival_time);
+
+    /**
+     * @brief Sample a buffered position at a given time
+     */
+    static void samplePosition(const component::network_state &state,
+                               double time, float &x, float &y);
+
+    struct SimulatedProjectile {
+        float origin_x;
+        float origin_y;
+        float velocity_x;
+        float velocity_y;
+        float age; ///< Seconds since the projectile was at the origin
+    };
+
+    struct PredictedInput {
+        uint32_t sequence = 0;
+        uint8_t buttons = 0;
+        float dt = 0.0f;
+    };
+
     registry &registry_;
     render::IRenderWindow &window_;
     PlayerManager &player_manager_;
@@ -118,6 +228,46 @@ class NetworkCommandHandler : public network::INetworkCommandHandler {
     std::atomic<bool> player_entity_created_{false};
     std::atomic<bool> victory_received_{false};
 
+    // Newest ENTITY_UPDATE(_COMPACT) tick applied, older (reordered) updates are dropped
+    uint32_t last_snapshot_tick_ = 0;
+
+    // Snapshot tick being applied by applyEntityUpdates, 0 outside of it
+    uint32_t applying_snapshot_tick_ = 0;
+
+    // Update chunks received for last_snapshot_tick_
+    uint8_t snapshot_chunk_count_ = 0;
+    std::bitset<256> snapshot_chunks_;
+
+    // Entities held back from the updates of deferred_tick_, sorted
+    uint32_t deferred_tick_ = 0;
+    std::vector<uint32_t> deferred_net_ids_;
+
+    // Remote entity interpolation, in seconds. Samples are on the server
+    // timeline, network_time_ and render times on the local tick clock.
+    static constexpr double MIN_PLAYOUT_DELAY = 0.03;
+    static constexpr double MAX_PLAYOUT_DELAY = 0.3;
+    static constexpr double MAX_EXTRAPOLATION = 0.25;
+    static constexpr double MAX_CLOCK_STEP = 1.0; ///< Offset change treated as a reset
+    double network_time_ = 0.0;
+    uint8_t server_tick_rate_ = 0; ///< From PLAYER_ASSIGNMENT, 0 if unknown
+    double last_snapshot_server_time_ = -1.0;
+    double last_transit_ = 0.0;   ///< Arrival minus server time of the last snapshot
+    double clock_offset_ = 0.0;   ///< Smoothed transit, local minus server time
+    double snapshot_interval_ = 1.0 / 30.0; ///< Smoothed time between snapshots
+    double snapshot_jitter_ = 0.0;          ///< Smoothed change in transit time
+    double playout_delay_ = 0.1;
+
+    // Local player prediction, inputs indexed by sequence % INPUT_HISTORY_SIZE
+    static constexpr uint32_t INPUT_HISTORY_SIZE = 128;
+    std::array<PredictedInput, INPUT_HISTORY_SIZE> input_history_{};
+    uint32_t latest_input_sequence_ = 0;
+    network::InputAckData input_ack_;
+    float predicted_x_ = 0.0f; ///< Normalized
+    float predicted_y_ = 0.0f;
+
+    // Projectiles moved locally instead of through entity updates, by net_id
+    std::unordered_map<uint32_t, SimulatedProjectile> simulated_projectiles_;
+
     mutable std::mutex net_id_mutex_;
     std::unordered_map<uint32_t, entity> net_id_to_entity_;
     network::PacketProcessor packet_processor_;
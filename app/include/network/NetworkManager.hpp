@@ -1,6 +1,8 @@
 #pragma once
 #include "../../../ecs/include/network/ANetworkManager.hpp"
 #include "PacketProcessor.hpp"
+#include <array>
+#include <bitset>
 #include <mutex>
 
 namespace network {
@@ -31,20 +33,52 @@ class NetworkManager : public ANetworkManager {
      */
     void sendPlayerInput(uint8_t direction);
 
+    /**
+     * @brief Sample the held buttons and send them with the previous frames
+     *
+     * Each INPUT_STATE repeats the last INPUT_REDUNDANCY frames so a lost
+     * datagram is covered by the next one.
+     * @param buttons network::InputButton bits
+     * @return Input sequence given to this frame
+     */
+    uint32_t sendInputState(uint8_t buttons);
+
   protected:
     void initializeUDPSocket() override;
 
   private:
     bool sendClientPing(uint32_t timestamp);
+    bool sendSnapshotAck(uint32_t snapshot_tick, uint32_t reliable_delivered,
+                         uint32_t reliable_bits);
     void handlePlayerAssignment(const UDPPacket &packet);
     void resetConnectionState();
 
+    /**
+     * @brief Records an ENTITY_UPDATE(_COMPACT) chunk
+     * @return True once every chunk of its tick arrived, the tick can be acked
+     */
+    bool updateComplete(const std::vector<uint8_t> &payload);
+
     PacketProcessor packet_processor_;
 
     mutable std::mutex player_mutex_;
     uint32_t assigned_player_net_id_ = 0;
     bool player_assigned_ = false;
 
+    uint32_t last_acked_tick_ = 0; ///< Latest ENTITY_UPDATE tick acked
+
+    /// Update chunks received for one tick
+    struct UpdateChunks {
+        uint32_t tick = 0;
+        uint8_t count = 0;
+        std::bitset<256> received;
+    };
+    std::array<UpdateChunks, 8> update_chunks_{};
+
+    static constexpr size_t INPUT_REDUNDANCY = 4;
+    uint32_t input_sequence_ = 0;
+    std::vector<InputFrameData> input_history_; ///< Newest first
+
     static constexpr int MAX_PING_RETRIES = 3;
     static constexpr float PING_RETRY_INTERVAL_S = 1.0f;
     static constexpr float PING_TOTAL_TIMEOUT_S = 10.0f;
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../../ecs/include/network/INetwork.hpp"
+#include <map>
 #include <queue>
 
 namespace network {
@@ -13,28 +14,74 @@ class PacketProcessor {
     void addPacket(const UDPPacket &packet);
     std::vector<UDPPacket> getProcessedPackets();
 
+    /**
+     * @brief Acknowledgement state of the server's reliable channel
+     * @param delivered Highest sequence delivered in order
+     * @param received_bits Bit i set if sequence delivered + 2 + i is buffered
+     * @return True if a reliable message arrived since the last call
+     */
+    bool takeReliableAck(uint32_t &delivered, uint32_t &received_bits);
+    void resetReliableChannel();
+    static bool isReliable(UDPMessageType type);
+
     static TCPMessage parseTCPMessage(const std::vector<uint8_t> &data);
     static std::vector<uint8_t> serializeTCPMessage(const TCPMessage &msg);
     static UDPPacket parseUDPPacket(const std::vector<uint8_t> &data);
+    static std::vector<UDPPacket>
+    parseUDPDatagram(const std::vector<uint8_t> &data);
     static std::vector<uint8_t> serializeUDPPacket(const UDPPacket &packet);
     static EntityData parseEntityCreate(const std::vector<uint8_t> &data);
     static std::vector<EntityUpdateData>
     parseEntityUpdate(const std::vector<uint8_t> &data);
+    static std::vector<EntityUpdateData>
+    parseEntityUpdateCompact(const std::vector<uint8_t> &data);
+    static uint32_t parseSnapshotTick(const std::vector<uint8_t> &data);
+    /**
+     * @brief Position of an entity update among the messages of its tick
+     * @return False if the header is truncated or the index out of range
+     */
+    static bool parseUpdateChunk(const std::vector<uint8_t> &data,
+                                 uint8_t &index, uint8_t &count);
+    static ProjectileSpawnBatch
+    parseProjectileSpawn(const std::vector<uint8_t> &data);
+    static InputAckData parseInputAck(const std::vector<uint8_t> &data);
     static std::vector<uint32_t>
     parseEntityDestroy(const std::vector<uint8_t> &data);
+    static std::vector<uint32_t>
+    parseEntityDeferred(const std::vector<uint8_t> &data);
     static std::vector<EntityData>
     parseGameState(const std::vector<uint8_t> &data);
     static uint32_t parsePlayerAssignment(const std::vector<uint8_t> &data);
     static std::vector<uint8_t>
     serializePlayerInput(const PlayerInputData &input);
     static UDPPacket createClientPing(uint32_t timestamp, uint8_t player_id);
+    static UDPPacket createSnapshotAck(uint32_t snapshot_tick,
+                                       uint32_t reliable_delivered,
+                                       uint32_t reliable_bits);
+    static UDPPacket
+    createInputState(const std::vector<InputFrameData> &frames);
     static uint32_t floatToNetwork(float value);
     static float networkToFloat(uint32_t value);
 
+    static constexpr size_t SNAPSHOT_TICK_SIZE = 4;
+    static constexpr size_t UPDATE_HEADER_SIZE = 6; // tick + chunk index and count
+    static constexpr size_t ENTITY_UPDATE_SIZE = 26;
+    static constexpr size_t CLIENT_PING_SIZE = 5; // timestamp + capabilities
+    static constexpr size_t PROJECTILE_SPAWN_HEADER_SIZE = 5;
+    static constexpr size_t PROJECTILE_SPAWN_SIZE = 25;
+    static constexpr size_t INPUT_ACK_SIZE = 8; // snapshot tick + input sequence
+    static constexpr size_t SNAPSHOT_ACK_SIZE = 12; // tick + reliable ack + bits
+    static constexpr uint32_t RELIABLE_WINDOW = 1024; // Sequences buffered ahead
+
   private:
     uint32_t next_send_sequence_;
     uint32_t last_received_sequence_;
     std::queue<UDPPacket> processed_packets_;
+
+    // Reliable channel: events are delivered in sequence order, exactly once
+    uint32_t next_reliable_sequence_ = 1;
+    std::map<uint32_t, UDPPacket> reliable_pending_; ///< Arrived ahead of a gap
+    bool reliable_received_ = false;
 };
 
 } // namespace network
\ No newline at end of file
@@ -11,8 +11,11 @@
 #include "network/NetworkManager.hpp"
 #include "ui/OptionsMenu.hpp"
 #include "core/settings.hpp"
+#include "network/CompactEntityCodec.hpp"
 #include "network/NetworkComponents.hpp"
 #include "network/NetworkSystem.hpp"
+#include "scripting/script_cache.hpp"
+#include "scripting/script_profiler.hpp"
 #include "systems.hpp"
 #include "GameConstants.hpp"
 #include <chrono>
@@ -32,6 +35,9 @@ Game::Game(registry &reg, render::IRenderWindow &win, AudioManager &audioMgr,
 
     std::srand(static_cast<unsigned>(std::time(nullptr)));
 
+    if (!_isMultiplayer)
+        scripting::preload_scripts();
+
     if (_isMultiplayer) {
         _registry.register_component<component::network_entity>();
         _registry.register_component<component::network_state>();
@@ -163,6 +169,15 @@ void Game::update(float dt) {
 
     _gameTime += dt;
 
+    scripting::script_profiler &profiler = scripting::script_profiler::instance();
+    if (profiler.enabled()) {
+        _scriptStatsTimer += dt;
+        if (_scriptStatsTimer >= _scriptStatsInterval) {
+            profiler.dump(std::cout, _scriptStatsTimer);
+            _scriptStatsTimer = 0.f;
+        }
+    }
+
     auto &positions = _registry.get_components<component::position>();
     auto &velocities = _registry.get_components<component::velocity>();
     auto &controllables = _registry.get_components<component::controllable>();
@@ -523,6 +538,12 @@ void Game::update(float dt) {
 void Game::render(float dt) {
     _window.clear();
 
+    if (_isMultiplayer && _networkCommandHandler) {
+        double render_time = _gameTime + _tickSystem.getInterpolationFactor() *
+                                             _tickSystem.getTickDelta();
+        _networkCommandHandler->interpolateRemoteEntities(render_time);
+    }
+
     auto &positions = _registry.get_components<component::position>();
     auto &drawables = _registry.get_components<component::drawable>();
     systems::render_system(_registry, positions, drawables, _window, dt);
@@ -855,7 +876,13 @@ void Game::updateMultiplayer(float dt) {
     _gameTime += dt;
 
     if (_networkManager) {
+        if (_networkCommandHandler) {
+            _networkCommandHandler->setNetworkTime(_gameTime);
+        }
         systems::network_system(dt);
+        if (_networkCommandHandler) {
+            _networkCommandHandler->updateSimulatedProjectiles(dt);
+        }
 
         // Check connection state
         auto connectionState = _networkManager->getConnectionState();
@@ -962,6 +989,7 @@ void Game::sendPlayerInput(float dt) {
     _inputSendTimer += dt;
 
     if (_inputSendTimer >= _inputSendInterval) {
+        float held_for = _inputSendTimer;
         _inputSendTimer = 0.0f;
 
         if (!_networkManager)
@@ -983,21 +1011,23 @@ void Game::sendPlayerInput(float dt) {
 
         auto &playerInput = inputs[*my_entity];
 
-        uint8_t direction = 0;
+        uint8_t buttons = 0;
         if (playerInput->up)
-            direction |= 0x01;
+            buttons |= network::INPUT_UP;
         if (playerInput->down)
-            direction |= 0x02;
+            buttons |= network::INPUT_DOWN;
         if (playerInput->left)
-            direction |= 0x04;
+            buttons |= network::INPUT_LEFT;
         if (playerInput->right)
-            direction |= 0x08;
+            buttons |= network::INPUT_RIGHT;
+        if (playerInput->fire)
+            buttons |= network::INPUT_SHOOT;
 
-        // Always send direction (even 0) so server knows when to stop
-        _networkManager->sendPlayerInput(direction);
+        // Always send the state (even 0) so server knows when to stop
+        uint32_t input_sequence = _networkManager->sendInputState(buttons);
 
-        if (playerInput->fire) {
-            _networkManager->sendPlayerFire();
-        }
+        // Move now instead of a round trip later, the server corrects us
+        _networkCommandHandler->predictLocalPlayer(input_sequence, buttons,
+                                                   held_for);
     }
 }
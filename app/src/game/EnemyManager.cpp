@@ -8,11 +8,11 @@
 #include "game/EnemyManager.hpp"
 #include "GameConstants.hpp"
 #include "entity.hpp"
-#include "lua_compat_fix.hpp"
+#include "scripting/lua_state_pool.hpp"
+#include "scripting/script_profiler.hpp"
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
-#include <sol/sol.hpp>
 
 EnemyManager::EnemyManager(registry &reg, render::IRenderWindow &win)
     : _registry(reg), _window(win) {
@@ -22,22 +22,13 @@ EnemyManager::EnemyManager(registry &reg, render::IRenderWindow &win)
 }
 
 entity EnemyManager::spawnEnemy() {
-    static sol::state lua;
-    static bool initialized = false;
-
-    if (!initialized) {
-        lua.open_libraries(sol::lib::base, sol::lib::math);
-        try {
-            lua.script_file("scripts/enemy_spawn.lua");
-        } catch (const sol::error &e) {
-            std::cerr << "[Lua Error] " << e.what() << std::endl;
-            return entity(-1);
-        }
-        initialized = true;
-    }
+    if (!scripting::script_loaded("scripts/enemy_spawn.lua"))
+        return entity(-1);
+
+    sol::state &lua = scripting::local_state();
 
-    sol::protected_function get_config = lua["get_enemy_config"];
-    sol::protected_function_result result = get_config();
+    sol::protected_function_result result =
+        scripting::call(lua, "get_enemy_config");
 
     if (!result.valid()) {
         sol::error err = result;
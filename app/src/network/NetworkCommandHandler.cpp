@@ -1,6 +1,8 @@
 ﻿#include "network/NetworkCommandHandler.hpp"
 #include "GameConstants.hpp"
+#include "network/PlayerMovement.hpp"
 #include "systems.hpp"
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <iostream>
@@ -17,6 +19,11 @@ NetworkCommandHandler::NetworkCommandHandler(registry &registry,
 
 void NetworkCommandHandler::onCreateEntity(
     const network::CreateEntityCommand &cmd) {
+    // A snapshot may have created it before its ENTITY_CREATE got through
+    if (findEntityByNetId(cmd.net_id)) {
+        return;
+    }
+
     entity new_entity(0);
 
     switch (cmd.entity_type) {
@@ -107,6 +114,13 @@ void NetworkCommandHandler::onUpdateEntity(
     const network::UpdateEntityCommand &cmd) {
     auto opt_entity = findEntityByNetId(cmd.net_id);
     if (!opt_entity) {
+        // The server sends every field for entities the client may not know,
+        // a partial update for an unknown entity cannot place it
+        const uint8_t required = network::FIELD_POSITION | network::FIELD_HEALTH;
+        if ((cmd.fields & required) != required) {
+            return;
+        }
+
         // Entity doesn't exist yet, create it using the entity_type from the packet
         network::CreateEntityCommand create_cmd;
         create_cmd.net_id = cmd.net_id;
@@ -130,16 +144,39 @@ void NetworkCommandHandler::onUpdateEntity(
     auto &healths = registry_.get_components<component::health>();
     auto &network_states = registry_.get_components<component::network_state>();
 
-    if (ent < positions.size() && positions[ent]) {
-        render::Vector2u window_size = window_.getSize();
-        float pixel_x = cmd.position_x * static_cast<float>(window_size.x);
-        float pixel_y = cmd.position_y * static_cast<float>(window_size.y);
+    float position_x = cmd.position_x;
+    float position_y = cmd.position_y;
+    bool apply_position = (cmd.fields & network::FIELD_POSITION) != 0;
+    if (apply_position && cmd.net_id == assigned_player_net_id_.load()) {
+        apply_position = reconcileLocalPlayer(position_x, position_y);
+    }
+
+    if (apply_position && ent < positions.size() && positions[ent]) {
+        // Remote entities are moved by interpolateRemoteEntities() from the
+        // buffered samples, only their first position is applied directly
+        bool buffered = false;
+        if (applying_snapshot_tick_ != 0 &&
+            cmd.net_id != assigned_player_net_id_.load() &&
+            ent < network_states.size() && network_states[ent]) {
+            component::network_state &state = *network_states[ent];
+            state.push_sample(snapshotTime(applying_snapshot_tick_), position_x,
+                              position_y);
+            state.last_sample_tick = applying_snapshot_tick_;
+            buffered = state.sample_count > 1;
+        }
+
+        if (!buffered) {
+            render::Vector2u window_size = window_.getSize();
+            float pixel_x = position_x * static_cast<float>(window_size.x);
+            float pixel_y = position_y * static_cast<float>(window_size.y);
 
-        positions[ent]->x = pixel_x;
-        positions[ent]->y = pixel_y;
+            positions[ent]->x = pixel_x;
+            positions[ent]->y = pixel_y;
+        }
     }
 
-    if (ent < healths.size() && healths[ent]) {
+    if ((cmd.fields & network::FIELD_HEALTH) && ent < healths.size() &&
+        healths[ent]) {
         uint32_t old_hp = healths[ent]->current_hp;
         uint32_t new_hp = cmd.health;
 
@@ -153,26 +190,28 @@ void NetworkCommandHandler::onUpdateEntity(
 
     // Update shield from server data
     auto &shields = registry_.get_components<component::shield>();
-    if (cmd.shield > 0) {
-        // Entity has shield
-        if (ent < shields.size() && shields[ent]) {
-            uint32_t old_shield = shields[ent]->current_shield;
-            uint32_t new_shield = cmd.shield;
-
-            // Create explosion effect if shield took damage
-            if (new_shield < old_shield && ent < positions.size() && positions[ent]) {
-                systems::create_explosion(registry_, positions[ent]->x, positions[ent]->y);
-            }
+    if (cmd.fields & network::FIELD_SHIELD) {
+        if (cmd.shield > 0) {
+            // Entity has shield
+            if (ent < shields.size() && shields[ent]) {
+                uint32_t old_shield = shields[ent]->current_shield;
+                uint32_t new_shield = cmd.shield;
+
+                // Create explosion effect if shield took damage
+                if (new_shield < old_shield && ent < positions.size() && positions[ent]) {
+                    systems::create_explosion(registry_, positions[ent]->x, positions[ent]->y);
+                }
 
-            shields[ent]->current_shield = cmd.shield;
+                shields[ent]->current_shield = cmd.shield;
+            } else {
+                // Add shield component if it doesn't exist
+                registry_.add_component<component::shield>(ent, component::shield(cmd.shield, 50));
+            }
         } else {
-            // Add shield component if it doesn't exist
-            registry_.add_component<component::shield>(ent, component::shield(cmd.shield, 50));
-        }
-    } else {
-        // No shield - remove component if it exists
-        if (ent < shields.size() && shields[ent]) {
-            shields.erase(ent);
+            // No shield - remove component if it exists
+            if (ent < shields.size() && shields[ent]) {
+                shields.erase(ent);
+            }
         }
     }
 
@@ -185,32 +224,29 @@ void NetworkCommandHandler::onUpdateEntity(
         safe_score = 0;
     }
 
-    if (ent < scores.size() && scores[ent]) {
-        scores[ent]->current_score = safe_score;
-
-        // If this is the local player, update player_score_ for HUD display
-        if (cmd.net_id == assigned_player_net_id_.load()) {
-            player_score_.store(safe_score);
-        }
-    } else {
-        // Score component doesn't exist - create it
-        if (ent < scores.size()) {
-            registry_.add_component<component::score>(ent, component::score(safe_score));
+    if (cmd.fields & network::FIELD_SCORE) {
+        if (ent < scores.size() && scores[ent]) {
+            scores[ent]->current_score = safe_score;
 
+            // If this is the local player, update player_score_ for HUD display
             if (cmd.net_id == assigned_player_net_id_.load()) {
                 player_score_.store(safe_score);
             }
-        }
-    }
+        } else {
+            // Score component doesn't exist - create it
+            if (ent < scores.size()) {
+                registry_.add_component<component::score>(ent, component::score(safe_score));
 
-    if (ent < network_states.size() && network_states[ent]) {
-        network_states[ent]->last_position.x = cmd.position_x;
-        network_states[ent]->last_position.y = cmd.position_y;
-        network_states[ent]->interpolation_time = 0.0f;
+                if (cmd.net_id == assigned_player_net_id_.load()) {
+                    player_score_.store(safe_score);
+                }
+            }
+        }
     }
 
     // Track beam state for all player entities
-    if (cmd.entity_type == network::EntityType::PLAYER) {
+    if (cmd.entity_type == network::EntityType::PLAYER &&
+        (cmd.fields & network::FIELD_FLAGS)) {
         if (cmd.flags & 0x01) {
             beam_active_net_ids_.insert(cmd.net_id);
         } else {
@@ -301,6 +337,7 @@ void NetworkCommandHandler::onDestroyEntity(
         net_id_to_entity_.erase(cmd.net_id);
     }
     beam_active_net_ids_.erase(cmd.net_id);
+    simulated_projectiles_.erase(cmd.net_id);
 }
 
 void NetworkCommandHandler::onFullStateSync(
@@ -333,6 +370,10 @@ void NetworkCommandHandler::onConnectionStatusChanged(
 void NetworkCommandHandler::onPlayerAssignment(
     const network::PlayerAssignmentCommand &cmd) {
     assigned_player_net_id_.store(cmd.player_net_id);
+
+    // A new session restarts the server tick count
+    server_tick_rate_ = cmd.tick_rate;
+    last_snapshot_server_time_ = -1.0;
 }
 
 std::optional<entity>
@@ -937,9 +978,10 @@ void NetworkCommandHandler::onRawUDPPacket(const network::UDPPacket &packet) {
         break;
 
     case network::UDPMessageType::PLAYER_ASSIGNMENT: {
-        if (packet.payload.size() != 4) {
+        if (packet.payload.size() != 4 && packet.payload.size() != 5) {
             std::cerr << "Invalid PLAYER_ASSIGNMENT size: "
-                      << packet.payload.size() << " (expected 4)" << std::endl;
+                      << packet.payload.size() << " (expected 4 or 5)"
+                      << std::endl;
             break;
         }
 
@@ -947,6 +989,7 @@ void NetworkCommandHandler::onRawUDPPacket(const network::UDPPacket &packet) {
             network::PacketProcessor::parsePlayerAssignment(packet.payload);
         network::PlayerAssignmentCommand cmd;
         cmd.player_net_id = player_net_id;
+        cmd.tick_rate = packet.payload.size() == 5 ? packet.payload[4] : 0;
         onPlayerAssignment(cmd);
         break;
     }
@@ -974,28 +1017,52 @@ void NetworkCommandHandler::onRawUDPPacket(const network::UDPPacket &packet) {
     }
 
     case network::UDPMessageType::ENTITY_UPDATE: {
-        if (packet.payload.size() == 0 || packet.payload.size() % 26 != 0) {
+        if (packet.payload.size() <
+                network::PacketProcessor::UPDATE_HEADER_SIZE ||
+            (packet.payload.size() -
+             network::PacketProcessor::UPDATE_HEADER_SIZE) %
+                    network::PacketProcessor::ENTITY_UPDATE_SIZE !=
+                0) {
             std::cerr << "Invalid ENTITY_UPDATE size: " << packet.payload.size()
-                      << " (must be multiple of 26)" << std::endl;
+                      << " (must be 6 + multiple of 26)" << std::endl;
             break;
         }
 
-        auto updates =
-            network::PacketProcessor::parseEntityUpdate(packet.payload);
-
-        for (const auto &update : updates) {
-            network::UpdateEntityCommand cmd;
-            cmd.net_id = update.net_id;
-            cmd.entity_type = update.entity_type;
-            cmd.health = update.health;
-            cmd.shield = update.shield;
-            cmd.position_x = update.position_x;
-            cmd.position_y = update.position_y;
-            cmd.score = update.score;
-            cmd.flags = update.flags;
-
-            onUpdateEntity(cmd);
+        applyEntityUpdates(
+            packet.payload,
+            network::PacketProcessor::parseEntityUpdate(packet.payload));
+        break;
+    }
+
+    case network::UDPMessageType::ENTITY_UPDATE_COMPACT: {
+        if (packet.payload.size() <=
+            network::PacketProcessor::UPDATE_HEADER_SIZE) {
+            std::cerr << "Invalid ENTITY_UPDATE_COMPACT size: "
+                      << packet.payload.size() << " (minimum 7)" << std::endl;
+            break;
         }
+
+        applyEntityUpdates(
+            packet.payload,
+            network::PacketProcessor::parseEntityUpdateCompact(packet.payload));
+        break;
+    }
+
+    case network::UDPMessageType::PROJECTILE_SPAWN: {
+        if (packet.payload.size() <
+                network::PacketProcessor::PROJECTILE_SPAWN_HEADER_SIZE ||
+            (packet.payload.size() -
+             network::PacketProcessor::PROJECTILE_SPAWN_HEADER_SIZE) %
+                    network::PacketProcessor::PROJECTILE_SPAWN_SIZE !=
+                0) {
+            std::cerr << "Invalid PROJECTILE_SPAWN size: "
+                      << packet.payload.size()
+                      << " (must be 5 + multiple of 25)" << std::endl;
+            break;
+        }
+
+        spawnSimulatedProjectiles(
+            network::PacketProcessor::parseProjectileSpawn(packet.payload));
         break;
     }
 
@@ -1052,7 +1119,53 @@ void NetworkCommandHandler::onRawUDPPacket(const network::UDPPacket &packet) {
         break;
     }
 
+    case network::UDPMessageType::INPUT_ACK: {
+        if (packet.payload.size() != network::PacketProcessor::INPUT_ACK_SIZE) {
+            std::cerr << "Invalid INPUT_ACK size: " << packet.payload.size()
+                      << " (expected 8)" << std::endl;
+            break;
+        }
+
+        // Sent just before the updates of the same snapshot
+        network::InputAckData ack =
+            network::PacketProcessor::parseInputAck(packet.payload);
+        if (ack.snapshot_tick >= input_ack_.snapshot_tick) {
+            input_ack_ = ack;
+        }
+        break;
+    }
+
+    case network::UDPMessageType::ENTITY_DEFERRED: {
+        if (packet.payload.size() <
+                network::PacketProcessor::SNAPSHOT_TICK_SIZE ||
+            (packet.payload.size() -
+             network::PacketProcessor::SNAPSHOT_TICK_SIZE) % 4 != 0) {
+            std::cerr << "Invalid ENTITY_DEFERRED size: "
+                      << packet.payload.size() << " (must be 4 + multiple of 4)"
+                      << std::endl;
+            break;
+        }
+
+        // Sent just before the updates of the same snapshot, possibly in
+        // several messages
+        uint32_t tick =
+            network::PacketProcessor::parseSnapshotTick(packet.payload);
+        if (tick > deferred_tick_) {
+            deferred_tick_ = tick;
+            deferred_net_ids_.clear();
+        }
+        if (tick == deferred_tick_) {
+            for (uint32_t net_id :
+                 network::PacketProcessor::parseEntityDeferred(packet.payload)) {
+                deferred_net_ids_.push_back(net_id);
+            }
+            std::sort(deferred_net_ids_.begin(), deferred_net_ids_.end());
+        }
+        break;
+    }
+
     case network::UDPMessageType::PLAYER_INPUT:
+    case network::UDPMessageType::INPUT_STATE:
         break;
 
     case network::UDPMessageType::VICTORY: {
@@ -1065,4 +1178,307 @@ void NetworkCommandHandler::onRawUDPPacket(const network::UDPPacket &packet) {
                   << static_cast<int>(packet.msg_type) << std::endl;
         break;
     }
-}
\ No newline at end of file
+}
+
+void NetworkCommandHandler::applyEntityUpdates(
+    const std::vector<uint8_t> &payload,
+    const std::vector<network::EntityUpdateData> &updates) {
+    uint32_t snapshot_tick = network::PacketProcessor::parseSnapshotTick(payload);
+    uint8_t chunk_index;
+    uint8_t chunk_count;
+    if (!network::PacketProcessor::parseUpdateChunk(payload, chunk_index,
+                                                    chunk_count) ||
+        snapshot_tick < last_snapshot_tick_) {
+        return;
+    }
+
+    if (snapshot_tick > last_snapshot_tick_) {
+        // The previous snapshot gets no more chunks, fill in its gaps
+        repeatUnchangedSamples(last_snapshot_tick_);
+        last_snapshot_tick_ = snapshot_tick;
+        snapshot_chunk_count_ = chunk_count;
+        snapshot_chunks_.reset();
+        updatePlayoutDelay(snapshotTime(snapshot_tick), network_time_);
+    }
+    snapshot_chunks_.set(chunk_index);
+    applying_snapshot_tick_ = snapshot_tick;
+
+    for (const auto &update : updates) {
+        network::UpdateEntityCommand cmd;
+        cmd.net_id = update.net_id;
+        cmd.entity_type = update.entity_type;
+        cmd.health = update.health;
+        cmd.shield = update.shield;
+        cmd.position_x = update.position_x;
+        cmd.position_y = update.position_y;
+        cmd.score = update.score;
+        cmd.flags = update.flags;
+        cmd.fields = update.fields;
+
+        onUpdateEntity(cmd);
+    }
+    applying_snapshot_tick_ = 0;
+}
+
+void NetworkCommandHandler::repeatUnchangedSamples(uint32_t snapshot_tick) {
+    // An entity missing from a snapshot only stood still if no chunk of it
+    // was lost and the server did not hold the entity back
+    if (snapshot_tick == 0 ||
+        snapshot_chunks_.count() != snapshot_chunk_count_) {
+        return;
+    }
+    bool has_deferred = deferred_tick_ == snapshot_tick;
+
+    auto &network_states = registry_.get_components<component::network_state>();
+    auto &network_entities =
+        registry_.get_components<component::network_entity>();
+    for (size_t i = 0; i < network_states.size(); ++i) {
+        auto &state = network_states[i];
+        if (!state || state->sample_count == 0 ||
+            state->last_sample_tick == snapshot_tick) {
+            continue;
+        }
+        if (has_deferred && i < network_entities.size() && network_entities[i] &&
+            std::binary_search(deferred_net_ids_.begin(), deferred_net_ids_.end(),
+                               network_entities[i]->network_id)) {
+            continue;
+        }
+
+        const component::position_sample &newest = state->sample(0);
+        state->push_sample(snapshotTime(snapshot_tick), newest.x, newest.y);
+        state->last_sample_tick = snapshot_tick;
+    }
+}
+
+double NetworkCommandHandler::snapshotTime(uint32_t snapshot_tick) const {
+    // Without the server tick rate, fall back to the arrival time
+    if (server_tick_rate_ == 0) {
+        return network_time_;
+    }
+    return static_cast<double>(snapshot_tick) / server_tick_rate_;
+}
+
+void NetworkCommandHandler::updatePlayoutDelay(double server_time,
+                                               double arrival_time) {
+    double transit = arrival_time - server_time;
+    if (last_snapshot_server_time_ < 0.0 ||
+        std::abs(transit - clock_offset_) > MAX_CLOCK_STEP) {
+        // First snapshot, or the server clock jumped: start over from it
+        clock_offset_ = transit;
+        snapshot_jitter_ = 0.0;
+    } else {
+        // Jitter is the RFC 3550 interarrival jitter, the change in transit
+        // time between consecutive snapshots
+        snapshot_interval_ +=
+            (server_time - last_snapshot_server_time_ - snapshot_interval_) / 16.0;
+        snapshot_jitter_ +=
+            (std::abs(transit - last_transit_) - snapshot_jitter_) / 16.0;
+        clock_offset_ += (transit - clock_offset_) / 16.0;
+
+        // One interval to have two samples to blend, plus jitter headroom
+        playout_delay_ = std::max(
+            MIN_PLAYOUT_DELAY,
+            std::min(snapshot_interval_ + 2.0 * snapshot_jitter_, MAX_PLAYOUT_DELAY));
+    }
+    last_snapshot_server_time_ = server_time;
+    last_transit_ = transit;
+}
+
+void NetworkCommandHandler::samplePosition(const component::network_state &state,
+                                           double time, float &x, float &y) {
+    const component::position_sample &newest = state.sample(0);
+    if (time >= newest.time) {
+        double ahead = std::min(time - newest.time, MAX_EXTRAPOLATION);
+        x = newest.x + static_cast<float>(state.last_velocity.vx * ahead);
+        y = newest.y + static_cast<float>(state.last_velocity.vy * ahead);
+        return;
+    }
+
+    for (size_t age = 1; age < state.sample_count; ++age) {
+        const component::position_sample &older = state.sample(age);
+        if (time < older.time) {
+            continue;
+        }
+
+        const component::position_sample &newer = state.sample(age - 1);
+        double span = newer.time - older.time;
+        float t = span > 0.0 ? static_cast<float>((time - older.time) / span) : 1.0f;
+        x = older.x + (newer.x - older.x) * t;
+        y = older.y + (newer.y - older.y) * t;
+        return;
+    }
+
+    // Older than the whole buffer, e.g. right after the entity appeared
+    const component::position_sample &oldest = state.sample(state.sample_count - 1);
+    x = oldest.x;
+    y = oldest.y;
+}
+
+void NetworkCommandHandler::interpolateRemoteEntities(double render_time) {
+    auto &positions = registry_.get_components<component::position>();
+    auto &network_states = registry_.get_components<component::network_state>();
+    render::Vector2u window_size = window_.getSize();
+    // Samples are on the server timeline, the offset maps local time onto it
+    double playout_time = render_time - clock_offset_ - playout_delay_;
+    uint32_t my_net_id = assigned_player_net_id_.load();
+
+    std::lock_guard<std::mutex> lock(net_id_mutex_);
+    for (const auto &[net_id, ent] : net_id_to_entity_) {
+        // The local player is predicted and projectiles simulated instead
+        if (net_id == my_net_id || simulated_projectiles_.count(net_id)) {
+            continue;
+        }
+        if (ent >= network_states.size() || !network_states[ent] ||
+            network_states[ent]->sample_count < 2 ||
+            ent >= positions.size() || !positions[ent]) {
+            continue;
+        }
+
+        float x;
+        float y;
+        samplePosition(*network_states[ent], playout_time, x, y);
+        positions[ent]->x = x * static_cast<float>(window_size.x);
+        positions[ent]->y = y * static_cast<float>(window_size.y);
+    }
+}
+
+void NetworkCommandHandler::predictLocalPlayer(uint32_t input_sequence,
+                                               uint8_t buttons, float dt) {
+    auto opt_entity = findEntityByNetId(assigned_player_net_id_.load());
+    if (!opt_entity) {
+        return;
+    }
+
+    entity ent = *opt_entity;
+    auto &positions = registry_.get_components<component::position>();
+    if (ent >= positions.size() || !positions[ent]) {
+        return;
+    }
+
+    render::Vector2u window_size = window_.getSize();
+    if (latest_input_sequence_ == 0) {
+        // First predicted frame, start from the last server position
+        predicted_x_ = positions[ent]->x / static_cast<float>(window_size.x);
+        predicted_y_ = positions[ent]->y / static_cast<float>(window_size.y);
+    }
+
+    input_history_[input_sequence % INPUT_HISTORY_SIZE] = {input_sequence, buttons, dt};
+    latest_input_sequence_ = input_sequence;
+
+    network::movement::stepPlayer(predicted_x_, predicted_y_, buttons, dt);
+    positions[ent]->x = predicted_x_ * static_cast<float>(window_size.x);
+    positions[ent]->y = predicted_y_ * static_cast<float>(window_size.y);
+
+    auto &net_inputs = registry_.get_components<component::network_input>();
+    if (ent >= net_inputs.size() || !net_inputs[ent]) {
+        registry_.add_component<component::network_input>(ent, component::network_input());
+    }
+    component::network_input &net_input = *net_inputs[ent];
+    net_input.input_sequence = input_sequence;
+    net_input.input_data.up = (buttons & network::INPUT_UP) != 0;
+    net_input.input_data.down = (buttons & network::INPUT_DOWN) != 0;
+    net_input.input_data.left = (buttons & network::INPUT_LEFT) != 0;
+    net_input.input_data.right = (buttons & network::INPUT_RIGHT) != 0;
+    net_input.input_data.fire = (buttons & network::INPUT_SHOOT) != 0;
+}
+
+bool NetworkCommandHandler::reconcileLocalPlayer(float &x, float &y) {
+    if (latest_input_sequence_ == 0) {
+        return true; // Not predicting, the server position is all we have
+    }
+
+    // Without the ack we cannot tell which inputs the position already has
+    if (applying_snapshot_tick_ == 0 ||
+        input_ack_.snapshot_tick != applying_snapshot_tick_) {
+        return false;
+    }
+
+    // Replay every input the server had not applied yet
+    uint32_t acked = input_ack_.input_sequence;
+    if (acked < latest_input_sequence_) {
+        uint32_t first = acked + 1;
+        if (latest_input_sequence_ - acked > INPUT_HISTORY_SIZE) {
+            first = latest_input_sequence_ - INPUT_HISTORY_SIZE + 1;
+        }
+        for (uint32_t seq = first; seq <= latest_input_sequence_; ++seq) {
+            const PredictedInput &input = input_history_[seq % INPUT_HISTORY_SIZE];
+            if (input.sequence == seq) {
+                network::movement::stepPlayer(x, y, input.buttons, input.dt);
+            }
+        }
+    }
+
+    predicted_x_ = x;
+    predicted_y_ = y;
+    return true;
+}
+
+void NetworkCommandHandler::spawnSimulatedProjectiles(
+    const network::ProjectileSpawnBatch &batch) {
+    for (const auto &projectile : batch.projectiles) {
+        // A joining client may get the same projectile twice
+        if (findEntityByNetId(projectile.net_id)) {
+            continue;
+        }
+
+        float age = 0.0f;
+        if (batch.tick_rate > 0 && batch.server_tick > projectile.spawn_tick) {
+            age = static_cast<float>(batch.server_tick - projectile.spawn_tick) /
+                  static_cast<float>(batch.tick_rate);
+        }
+
+        network::CreateEntityCommand cmd;
+        cmd.net_id = projectile.net_id;
+        cmd.entity_type = projectile.entity_type;
+        cmd.health = 0;
+        cmd.shield = 0;
+        cmd.position_x = projectile.origin_x + projectile.velocity_x * age;
+        cmd.position_y = projectile.origin_y + projectile.velocity_y * age;
+
+        onCreateEntity(cmd);
+        simulated_projectiles_[projectile.net_id] = {
+            projectile.origin_x, projectile.origin_y, projectile.velocity_x,
+            projectile.velocity_y, age};
+    }
+}
+
+void NetworkCommandHandler::updateSimulatedProjectiles(float dt) {
+    // Same bounds and lifetime as the server projectile cleanup
+    const float MIN_BOUND = -0.1f;
+    const float MAX_BOUND = 1.1f;
+    const float LIFETIME = 5.0f;
+
+    auto &positions = registry_.get_components<component::position>();
+    render::Vector2u window_size = window_.getSize();
+    std::vector<uint32_t> expired;
+
+    for (auto &entry : simulated_projectiles_) {
+        SimulatedProjectile &projectile = entry.second;
+        projectile.age += dt;
+
+        float x = projectile.origin_x + projectile.velocity_x * projectile.age;
+        float y = projectile.origin_y + projectile.velocity_y * projectile.age;
+        if (x < MIN_BOUND || x > MAX_BOUND || y < MIN_BOUND || y > MAX_BOUND ||
+            projectile.age > LIFETIME) {
+            expired.push_back(entry.first);
+            continue;
+        }
+
+        auto opt_entity = findEntityByNetId(entry.first);
+        if (!opt_entity) {
+            expired.push_back(entry.first);
+            continue;
+        }
+        if (*opt_entity < positions.size() && positions[*opt_entity]) {
+            positions[*opt_entity]->x = x * static_cast<float>(window_size.x);
+            positions[*opt_entity]->y = y * static_cast<float>(window_size.y);
+        }
+    }
+
+    for (uint32_t net_id : expired) {
+        network::DestroyEntityCommand cmd;
+        cmd.net_id = net_id;
+        onDestroyEntity(cmd);
+        simulated_projectiles_.erase(net_id);
+    }
+}
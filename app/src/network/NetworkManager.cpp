@@ -1,5 +1,6 @@
 ﻿#include "network/NetworkManager.hpp"
 #include "network/ASIOSocket.hpp"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -22,22 +23,72 @@ std::vector<TCPMessage> NetworkManager::pollTCP() {
 
 std::vector<UDPPacket> NetworkManager::pollUDP() {
     auto raw_packets = pollRawUDP();
+    uint32_t newest_tick = last_acked_tick_;
 
     for (const auto &raw_packet : raw_packets) {
-        UDPPacket packet = PacketProcessor::parseUDPPacket(raw_packet.data);
+        for (const UDPPacket &packet :
+             PacketProcessor::parseUDPDatagram(raw_packet.data)) {
+            if ((packet.msg_type == UDPMessageType::ENTITY_UPDATE ||
+                 packet.msg_type == UDPMessageType::ENTITY_UPDATE_COMPACT) &&
+                updateComplete(packet.payload)) {
+                newest_tick = std::max(
+                    newest_tick,
+                    PacketProcessor::parseSnapshotTick(packet.payload));
+            }
 
-        if (packet.msg_type == UDPMessageType::PLAYER_ASSIGNMENT) {
-            handlePlayerAssignment(packet);
+            packet_processor_.addPacket(packet);
         }
+    }
 
-        packet_processor_.addPacket(packet);
+    // One ack per poll for the newest complete snapshot, the server deltas
+    // against it.
+    // The reliable channel state rides along, and forces an ack of its own.
+    uint32_t reliable_delivered;
+    uint32_t reliable_bits;
+    bool reliable_due =
+        packet_processor_.takeReliableAck(reliable_delivered, reliable_bits);
+    if ((newest_tick > last_acked_tick_ || reliable_due) &&
+        sendSnapshotAck(newest_tick, reliable_delivered, reliable_bits)) {
+        last_acked_tick_ = newest_tick;
     }
 
+    // Reliable messages come out in order, the assignment before the state
     auto processed_packets = packet_processor_.getProcessedPackets();
+    for (const UDPPacket &packet : processed_packets) {
+        if (packet.msg_type == UDPMessageType::PLAYER_ASSIGNMENT) {
+            handlePlayerAssignment(packet);
+        }
+    }
 
     return processed_packets;
 }
 
+bool NetworkManager::updateComplete(const std::vector<uint8_t> &payload) {
+    uint8_t index;
+    uint8_t count;
+    if (!PacketProcessor::parseUpdateChunk(payload, index, count)) {
+        return false;
+    }
+
+    uint32_t tick = PacketProcessor::parseSnapshotTick(payload);
+    if (tick <= last_acked_tick_) {
+        return false;
+    }
+
+    // Chunks of a tick arrive close together, a few recent ticks are enough
+    UpdateChunks &chunks = update_chunks_[tick % update_chunks_.size()];
+    if (chunks.tick != tick) {
+        chunks.tick = tick;
+        chunks.count = count;
+        chunks.received.reset();
+    }
+    if (count != chunks.count) {
+        return false;
+    }
+    chunks.received.set(index);
+    return chunks.received.count() == count;
+}
+
 bool NetworkManager::sendTCP(MessageType msg_type,
                              const std::vector<uint8_t> &data) {
     TCPMessage msg;
@@ -73,8 +124,17 @@ bool NetworkManager::sendClientPing(uint32_t timestamp) {
     return sendUDP(ping_packet);
 }
 
+bool NetworkManager::sendSnapshotAck(uint32_t snapshot_tick,
+                                     uint32_t reliable_delivered,
+                                     uint32_t reliable_bits) {
+    UDPPacket ack_packet = PacketProcessor::createSnapshotAck(
+        snapshot_tick, reliable_delivered, reliable_bits);
+    ack_packet.sequence_num = packet_processor_.getNextSendSequence();
+    return sendUDP(ack_packet);
+}
+
 void NetworkManager::handlePlayerAssignment(const UDPPacket &packet) {
-    if (packet.payload.size() != 4) {
+    if (packet.payload.size() < 4) {
         return;
     }
 
@@ -171,6 +231,11 @@ void NetworkManager::resetConnectionState() {
     std::lock_guard<std::mutex> lock(player_mutex_);
     assigned_player_net_id_ = 0;
     player_assigned_ = false;
+    last_acked_tick_ = 0;
+    update_chunks_.fill(UpdateChunks{});
+    input_sequence_ = 0;
+    input_history_.clear();
+    packet_processor_.resetReliableChannel();
     udp_ping_sent_ = false;
     ping_retry_count_ = 0;
 }
@@ -186,6 +251,18 @@ void NetworkManager::sendPlayerFire() {
     sendUDP(packet);
 }
 
+uint32_t NetworkManager::sendInputState(uint8_t buttons) {
+    if (input_history_.size() == INPUT_REDUNDANCY) {
+        input_history_.pop_back();
+    }
+    input_history_.insert(input_history_.begin(), {++input_sequence_, buttons});
+
+    UDPPacket packet = PacketProcessor::createInputState(input_history_);
+    packet.sequence_num = packet_processor_.getNextSendSequence();
+    sendUDP(packet);
+    return input_sequence_;
+}
+
 void NetworkManager::sendPlayerInput(uint8_t direction) {
     UDPPacket packet;
     packet.msg_type = UDPMessageType::PLAYER_INPUT;
@@ -6,6 +6,7 @@
 */
 
 #include "network/PacketProcessor.hpp"
+#include "network/CompactEntityCodec.hpp"
 #include <arpa/inet.h>
 #include <cstring>
 #include <iostream>
@@ -20,7 +21,64 @@ uint32_t PacketProcessor::getNextSendSequence() {
 }
 
 void PacketProcessor::addPacket(const UDPPacket &packet) {
-    processed_packets_.push(packet);
+    if (!isReliable(packet.msg_type)) {
+        processed_packets_.push(packet);
+        return;
+    }
+
+    // Duplicates still need an ack, the previous one may have been lost
+    reliable_received_ = true;
+    uint32_t sequence = packet.sequence_num;
+    if (sequence < next_reliable_sequence_ ||
+        sequence - next_reliable_sequence_ >= RELIABLE_WINDOW) {
+        return;
+    }
+
+    reliable_pending_.emplace(sequence, packet);
+    auto it = reliable_pending_.begin();
+    while (it != reliable_pending_.end() &&
+           it->first == next_reliable_sequence_) {
+        processed_packets_.push(it->second);
+        it = reliable_pending_.erase(it);
+        ++next_reliable_sequence_;
+    }
+}
+
+bool PacketProcessor::takeReliableAck(uint32_t &delivered,
+                                      uint32_t &received_bits) {
+    delivered = next_reliable_sequence_ - 1;
+    received_bits = 0;
+    for (const auto &entry : reliable_pending_) {
+        uint32_t offset = entry.first - delivered - 2;
+        if (offset >= 32) {
+            break;
+        }
+        received_bits |= 1u << offset;
+    }
+
+    bool received = reliable_received_;
+    reliable_received_ = false;
+    return received;
+}
+
+void PacketProcessor::resetReliableChannel() {
+    next_reliable_sequence_ = 1;
+    reliable_pending_.clear();
+    reliable_received_ = false;
+}
+
+bool PacketProcessor::isReliable(UDPMessageType type) {
+    switch (type) {
+    case UDPMessageType::ENTITY_CREATE:
+    case UDPMessageType::ENTITY_DESTROY:
+    case UDPMessageType::VICTORY:
+    case UDPMessageType::PLAYER_ASSIGNMENT:
+    case UDPMessageType::GAME_STATE:
+    case UDPMessageType::PROJECTILE_SPAWN:
+        return true;
+    default:
+        return false;
+    }
 }
 
 std::vector<UDPPacket> PacketProcessor::getProcessedPackets() {
@@ -103,6 +161,30 @@ UDPPacket PacketProcessor::parseUDPPacket(const std::vector<uint8_t> &data) {
     return packet;
 }
 
+std::vector<UDPPacket>
+PacketProcessor::parseUDPDatagram(const std::vector<uint8_t> &data) {
+    std::vector<UDPPacket> packets;
+    size_t offset = 0;
+
+    // The server may pack several messages back to back, each with its header
+    while (data.size() - offset >= 8) {
+        size_t data_length = (static_cast<size_t>(data[offset + 1]) << 16) |
+                             (static_cast<size_t>(data[offset + 2]) << 8) |
+                             static_cast<size_t>(data[offset + 3]);
+        if (data_length > data.size() - offset - 8) {
+            std::cerr << "[PacketProcessor] Truncated UDP message in datagram"
+                      << std::endl;
+            break;
+        }
+
+        packets.push_back(parseUDPPacket(std::vector<uint8_t>(
+            data.begin() + offset, data.begin() + offset + 8 + data_length)));
+        offset += 8 + data_length;
+    }
+
+    return packets;
+}
+
 std::vector<uint8_t>
 PacketProcessor::serializeUDPPacket(const UDPPacket &packet) {
     std::vector<uint8_t> result;
@@ -168,15 +250,16 @@ std::vector<EntityUpdateData>
 PacketProcessor::parseEntityUpdate(const std::vector<uint8_t> &data) {
     std::vector<EntityUpdateData> updates;
 
-    // ENTITY_UPDATE_SIZE = 26 bytes per entity
-    if (data.size() % 26 != 0) {
+    // Update header, then ENTITY_UPDATE_SIZE bytes per entity
+    if (data.size() < UPDATE_HEADER_SIZE ||
+        (data.size() - UPDATE_HEADER_SIZE) % ENTITY_UPDATE_SIZE != 0) {
         return updates;
     }
 
-    size_t num_entities = data.size() / 26;
+    size_t num_entities = (data.size() - UPDATE_HEADER_SIZE) / ENTITY_UPDATE_SIZE;
 
     for (size_t i = 0; i < num_entities; ++i) {
-        size_t offset = i * 26;
+        size_t offset = UPDATE_HEADER_SIZE + i * ENTITY_UPDATE_SIZE;
         EntityUpdateData update;
 
         uint32_t net_id_network;
@@ -221,6 +304,128 @@ PacketProcessor::parseEntityUpdate(const std::vector<uint8_t> &data) {
     return updates;
 }
 
+std::vector<EntityUpdateData>
+PacketProcessor::parseEntityUpdateCompact(const std::vector<uint8_t> &data) {
+    std::vector<EntityUpdateData> updates;
+
+    // Update header, then the bit-packed entity list
+    if (data.size() <= UPDATE_HEADER_SIZE) {
+        return updates;
+    }
+
+    BitReader reader(data.data() + UPDATE_HEADER_SIZE,
+                     data.size() - UPDATE_HEADER_SIZE);
+    std::vector<CompactEntity> entities;
+    if (!compact::decode(reader, entities)) {
+        std::cerr << "[PacketProcessor] Truncated ENTITY_UPDATE_COMPACT"
+                  << std::endl;
+        return updates;
+    }
+
+    updates.reserve(entities.size());
+    for (const CompactEntity &entity : entities) {
+        EntityUpdateData update;
+        update.net_id = entity.net_id;
+        update.entity_type = static_cast<EntityType>(entity.entity_type);
+        update.health = entity.health;
+        update.shield = entity.shield;
+        update.position_x = entity.position_x;
+        update.position_y = entity.position_y;
+        update.score = entity.score;
+        update.flags = entity.flags;
+        update.fields = entity.fields;
+        updates.push_back(update);
+    }
+
+    return updates;
+}
+
+uint32_t PacketProcessor::parseSnapshotTick(const std::vector<uint8_t> &data) {
+    if (data.size() < SNAPSHOT_TICK_SIZE) {
+        return 0;
+    }
+
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) |
+           static_cast<uint32_t>(data[3]);
+}
+
+bool PacketProcessor::parseUpdateChunk(const std::vector<uint8_t> &data,
+                                       uint8_t &index, uint8_t &count) {
+    if (data.size() < UPDATE_HEADER_SIZE) {
+        return false;
+    }
+
+    index = data[SNAPSHOT_TICK_SIZE];
+    count = data[SNAPSHOT_TICK_SIZE + 1];
+    return index < count;
+}
+
+InputAckData PacketProcessor::parseInputAck(const std::vector<uint8_t> &data) {
+    InputAckData ack;
+    if (data.size() < INPUT_ACK_SIZE) {
+        return ack;
+    }
+
+    ack.snapshot_tick = parseSnapshotTick(data);
+    ack.input_sequence = (static_cast<uint32_t>(data[4]) << 24) |
+                         (static_cast<uint32_t>(data[5]) << 16) |
+                         (static_cast<uint32_t>(data[6]) << 8) |
+                         static_cast<uint32_t>(data[7]);
+    return ack;
+}
+
+ProjectileSpawnBatch
+PacketProcessor::parseProjectileSpawn(const std::vector<uint8_t> &data) {
+    ProjectileSpawnBatch batch;
+
+    // SERVER_TICK, TICK_RATE, then PROJECTILE_SPAWN_SIZE bytes per projectile
+    if (data.size() < PROJECTILE_SPAWN_HEADER_SIZE ||
+        (data.size() - PROJECTILE_SPAWN_HEADER_SIZE) % PROJECTILE_SPAWN_SIZE !=
+            0) {
+        return batch;
+    }
+
+    batch.server_tick = parseSnapshotTick(data);
+    batch.tick_rate = data[4];
+
+    size_t count =
+        (data.size() - PROJECTILE_SPAWN_HEADER_SIZE) / PROJECTILE_SPAWN_SIZE;
+    batch.projectiles.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = PROJECTILE_SPAWN_HEADER_SIZE + i * PROJECTILE_SPAWN_SIZE;
+        ProjectileSpawnData projectile;
+
+        uint32_t net_id_network;
+        std::memcpy(&net_id_network, &data[offset], 4);
+        projectile.net_id = ntohl(net_id_network);
+        offset += 4;
+
+        projectile.entity_type = static_cast<EntityType>(data[offset]);
+        offset += 1;
+
+        uint32_t spawn_tick_network;
+        std::memcpy(&spawn_tick_network, &data[offset], 4);
+        projectile.spawn_tick = ntohl(spawn_tick_network);
+        offset += 4;
+
+        float *values[4] = {&projectile.origin_x, &projectile.origin_y,
+                            &projectile.velocity_x, &projectile.velocity_y};
+        for (float *value : values) {
+            uint32_t value_network;
+            std::memcpy(&value_network, &data[offset], 4);
+            *value = networkToFloat(value_network);
+            offset += 4;
+        }
+
+        batch.projectiles.push_back(projectile);
+    }
+
+    return batch;
+}
+
 std::vector<uint32_t>
 PacketProcessor::parseEntityDestroy(const std::vector<uint8_t> &data) {
     std::vector<uint32_t> net_ids;
@@ -243,6 +448,17 @@ PacketProcessor::parseEntityDestroy(const std::vector<uint8_t> &data) {
     return net_ids;
 }
 
+std::vector<uint32_t>
+PacketProcessor::parseEntityDeferred(const std::vector<uint8_t> &data) {
+    // SNAPSHOT_TICK, then the same NET_ID list as ENTITY_DESTROY
+    if (data.size() < SNAPSHOT_TICK_SIZE) {
+        return {};
+    }
+
+    return parseEntityDestroy(
+        std::vector<uint8_t>(data.begin() + SNAPSHOT_TICK_SIZE, data.end()));
+}
+
 std::vector<EntityData>
 PacketProcessor::parseGameState(const std::vector<uint8_t> &data) {
     std::vector<EntityData> entities;
@@ -302,15 +518,58 @@ UDPPacket PacketProcessor::createClientPing(uint32_t timestamp,
 
     UDPPacket packet;
     packet.msg_type = UDPMessageType::CLIENT_PING;
-    packet.data_length = 4;
+    packet.data_length = CLIENT_PING_SIZE;
     packet.sequence_num = 0;
 
     packet.payload.clear();
-    packet.payload.reserve(4);
+    packet.payload.reserve(CLIENT_PING_SIZE);
     packet.payload.push_back((timestamp >> 24) & 0xFF);
     packet.payload.push_back((timestamp >> 16) & 0xFF);
     packet.payload.push_back((timestamp >> 8) & 0xFF);
     packet.payload.push_back(timestamp & 0xFF);
+    packet.payload.push_back(CAP_COMPACT_UPDATES | CAP_PROJECTILE_SPAWN |
+                             CAP_AGGREGATED_DATAGRAMS | CAP_RELIABLE_EVENTS |
+                             CAP_DEFERRED_UPDATES);
+
+    return packet;
+}
+
+UDPPacket PacketProcessor::createSnapshotAck(uint32_t snapshot_tick,
+                                             uint32_t reliable_delivered,
+                                             uint32_t reliable_bits) {
+    UDPPacket packet;
+    packet.msg_type = UDPMessageType::SNAPSHOT_ACK;
+    packet.data_length = SNAPSHOT_ACK_SIZE;
+    packet.sequence_num = 0;
+
+    packet.payload.reserve(SNAPSHOT_ACK_SIZE);
+    for (uint32_t value : {snapshot_tick, reliable_delivered, reliable_bits}) {
+        packet.payload.push_back((value >> 24) & 0xFF);
+        packet.payload.push_back((value >> 16) & 0xFF);
+        packet.payload.push_back((value >> 8) & 0xFF);
+        packet.payload.push_back(value & 0xFF);
+    }
+
+    return packet;
+}
+
+UDPPacket
+PacketProcessor::createInputState(const std::vector<InputFrameData> &frames) {
+    UDPPacket packet;
+    packet.msg_type = UDPMessageType::INPUT_STATE;
+    packet.sequence_num = 0;
+
+    // Frames are written newest first, as given
+    packet.payload.reserve(1 + frames.size() * 5);
+    packet.payload.push_back(static_cast<uint8_t>(frames.size()));
+    for (const auto &frame : frames) {
+        packet.payload.push_back((frame.sequence >> 24) & 0xFF);
+        packet.payload.push_back((frame.sequence >> 16) & 0xFF);
+        packet.payload.push_back((frame.sequence >> 8) & 0xFF);
+        packet.payload.push_back(frame.sequence & 0xFF);
+        packet.payload.push_back(frame.buttons);
+    }
+    packet.data_length = static_cast<uint32_t>(packet.payload.size());
 
     return packet;
 }
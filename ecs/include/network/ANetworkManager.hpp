@@ -1,6 +1,7 @@
 #pragma once
 #include "INetwork.hpp"
 #include "ISocket.hpp"
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -71,6 +72,11 @@ class ANetworkManager : public INetwork {
 
     /**
      * @brief Send raw UDP data
+     *
+     * On a shared port the session token from TCP_GAME_START is put in
+     * front, the server routes the datagram to the game with it. The
+     * prefixed datagram is built in a reused buffer, guarded so the I/O
+     * and game threads may both send.
      * @param data Raw bytes to send
      * @return true if sent successfully
      */
@@ -137,10 +143,12 @@ class ANetworkManager : public INetwork {
     mutable std::mutex state_mutex_;
     mutable std::mutex tcp_queue_mutex_;
     mutable std::mutex udp_queue_mutex_;
+    std::mutex udp_send_mutex_; ///< Guards udp_send_buffer_
 
     ConnectionState state_;
     uint8_t player_id_;
     uint16_t udp_port_;
+    std::atomic<uint64_t> session_token_{0}; ///< 0 when the game has its own port
     std::string server_host_;
 
     std::queue<RawTCPMessage> raw_tcp_queue_;
@@ -149,6 +157,7 @@ class ANetworkManager : public INetwork {
     std::vector<uint8_t> tcp_header_buffer_;
     std::vector<uint8_t> tcp_payload_buffer_;
     std::vector<uint8_t> udp_read_buffer_;
+    std::vector<uint8_t> udp_send_buffer_; ///< Token and datagram being sent
 
     std::chrono::steady_clock::time_point last_activity_;
     std::chrono::steady_clock::time_point connection_start_;
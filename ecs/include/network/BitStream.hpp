@@ -0,0 +1,158 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace network {
+
+/**
+ * @class BitWriter
+ * @brief Appends values of arbitrary bit width to a byte buffer (MSB first)
+ *
+ * Header-only so the server can use it without linking the ecs library.
+ */
+class BitWriter {
+  public:
+    BitWriter() = default;
+
+    /**
+     * @brief Start writing after existing bytes (e.g. a fixed header)
+     */
+    explicit BitWriter(std::vector<uint8_t> prefix)
+        : buffer_(std::move(prefix)) {}
+
+    /**
+     * @brief Write the low @p bits bits of @p value
+     * @param value Value to write
+     * @param bits Number of bits (1-32)
+     */
+    void writeBits(uint32_t value, unsigned bits) {
+        for (unsigned i = bits; i > 0; --i) {
+            if (bit_pos_ == 0)
+                buffer_.push_back(0);
+            if ((value >> (i - 1)) & 1u)
+                buffer_.back() |= static_cast<uint8_t>(0x80u >> bit_pos_);
+            bit_pos_ = (bit_pos_ + 1) & 7u;
+        }
+    }
+
+    void writeBool(bool value) { writeBits(value ? 1u : 0u, 1); }
+
+    /**
+     * @brief Write an unsigned integer in 7-bit groups, low group first
+     *
+     * Each group is followed by a continuation bit, so values under 128 cost
+     * a single byte.
+     */
+    void writeVarUint(uint32_t value) {
+        do {
+            uint32_t group = value & 0x7Fu;
+            value >>= 7;
+            writeBits(group, 7);
+            writeBool(value != 0);
+        } while (value != 0);
+    }
+
+    /**
+     * @brief Write @p value, clamped to [min, max], on @p bits bits
+     */
+    void writeQuantized(float value, float min, float max, unsigned bits) {
+        const uint32_t steps = (1u << bits) - 1u;
+        if (value < min)
+            value = min;
+        if (value > max)
+            value = max;
+        float normalized = (value - min) / (max - min);
+        writeBits(static_cast<uint32_t>(normalized * static_cast<float>(steps) +
+                                        0.5f),
+                  bits);
+    }
+
+    /**
+     * @brief Start over, keeping the buffer capacity
+     */
+    void clear() {
+        buffer_.clear();
+        bit_pos_ = 0;
+    }
+
+    const std::vector<uint8_t> &data() const { return buffer_; }
+    std::vector<uint8_t> &data() { return buffer_; }
+    size_t sizeBytes() const { return buffer_.size(); }
+
+  private:
+    std::vector<uint8_t> buffer_;
+    unsigned bit_pos_ = 0;
+};
+
+/**
+ * @class BitReader
+ * @brief Reads values written by BitWriter
+ *
+ * Reading past the end sets the error flag and returns zeros, so callers
+ * only need to check ok() once after decoding a message.
+ */
+class BitReader {
+  public:
+    BitReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    uint32_t readBits(unsigned bits) {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < bits; ++i) {
+            if (byte_pos_ >= size_) {
+                error_ = true;
+                return 0;
+            }
+            uint32_t bit = (data_[byte_pos_] >> (7u - bit_pos_)) & 1u;
+            value = (value << 1) | bit;
+            if (++bit_pos_ == 8) {
+                bit_pos_ = 0;
+                ++byte_pos_;
+            }
+        }
+        return value;
+    }
+
+    bool readBool() { return readBits(1) != 0; }
+
+    uint32_t readVarUint() {
+        uint32_t value = 0;
+        unsigned shift = 0;
+        bool more = true;
+        while (more && shift < 35) {
+            value |= readBits(7) << shift;
+            more = readBool();
+            shift += 7;
+        }
+        if (more)
+            error_ = true;
+        return value;
+    }
+
+    float readQuantized(float min, float max, unsigned bits) {
+        const uint32_t steps = (1u << bits) - 1u;
+        return min + (max - min) * static_cast<float>(readBits(bits)) /
+                         static_cast<float>(steps);
+    }
+
+    bool ok() const { return !error_; }
+
+    /**
+     * @brief True once every whole byte has been consumed
+     *
+     * Padding bits of the last byte are ignored.
+     */
+    bool atEnd() const {
+        return byte_pos_ >= size_ || (byte_pos_ + 1 == size_ && bit_pos_ > 0);
+    }
+
+  private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t byte_pos_ = 0;
+    unsigned bit_pos_ = 0;
+    bool error_ = false;
+};
+
+} // namespace network
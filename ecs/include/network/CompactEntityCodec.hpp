@@ -0,0 +1,157 @@
+#pragma once
+#include "BitStream.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace network {
+
+/**
+ * @brief Capability bits sent in the optional 5th byte of CLIENT_PING
+ */
+enum ClientCapability : uint8_t {
+    CAP_COMPACT_UPDATES = 0x01, ///< Understands ENTITY_UPDATE_COMPACT
+    CAP_PROJECTILE_SPAWN = 0x02, ///< Simulates projectiles from PROJECTILE_SPAWN
+    CAP_AGGREGATED_DATAGRAMS = 0x04, ///< Reads several messages per datagram
+    CAP_RELIABLE_EVENTS = 0x08, ///< Orders and acks messages of the reliable channel
+    CAP_DEFERRED_UPDATES = 0x10 ///< Reads ENTITY_DEFERRED
+};
+
+/**
+ * @brief Button bits of an INPUT_STATE frame
+ */
+enum InputButton : uint8_t {
+    INPUT_UP = 0x01,
+    INPUT_DOWN = 0x02,
+    INPUT_LEFT = 0x04,
+    INPUT_RIGHT = 0x08,
+    INPUT_SHOOT = 0x10
+};
+
+/**
+ * @brief Fields present in an entity record, see CompactEntity::fields
+ */
+enum EntityField : uint8_t {
+    FIELD_POSITION = 0x01,
+    FIELD_HEALTH = 0x02,
+    FIELD_SHIELD = 0x04,
+    FIELD_SCORE = 0x08,
+    FIELD_FLAGS = 0x10,
+    FIELD_ALL = 0x1F
+};
+
+/**
+ * @struct CompactEntity
+ * @brief Entity fields carried by ENTITY_UPDATE_COMPACT
+ *
+ * Shared by the server encoder and the client decoder so both sides agree
+ * on quantization and field order.
+ */
+struct CompactEntity {
+    uint32_t net_id = 0;
+    uint8_t entity_type = 0;
+    uint32_t health = 0;
+    uint32_t shield = 0;
+    float position_x = 0.0f;
+    float position_y = 0.0f;
+    uint32_t score = 0;
+    uint8_t flags = 0;
+    uint8_t fields = FIELD_ALL; ///< EntityField bits, absent fields are unchanged
+};
+
+namespace compact {
+
+constexpr uint8_t PLAYER_TYPE = 0x01; ///< Only players carry shield and score
+constexpr unsigned TYPE_BITS = 5;
+constexpr unsigned POSITION_BITS = 16;
+constexpr unsigned HEALTH_BITS = 12;
+constexpr unsigned SHIELD_BITS = 8;
+constexpr unsigned FLAG_BITS = 1;
+constexpr unsigned FIELD_BITS = 5;
+
+// Entities spawn and despawn slightly off-screen, keep some margin
+constexpr float POSITION_MIN = -0.5f;
+constexpr float POSITION_MAX = 1.5f;
+
+inline uint32_t clampBits(uint32_t value, unsigned bits) {
+    const uint32_t max = (1u << bits) - 1u;
+    return value > max ? max : value;
+}
+
+/**
+ * @brief Encode entities sorted by net_id
+ *
+ * Layout: COUNT (varint), then per entity NET_ID delta from the previous
+ * entity (varint), TYPE, FIELDS mask, and only the fields it lists: X and
+ * Y, HEALTH, FLAGS, and for players SHIELD and SCORE (varint).
+ */
+inline void encode(BitWriter &writer, const std::vector<CompactEntity> &entities) {
+    writer.writeVarUint(static_cast<uint32_t>(entities.size()));
+
+    uint32_t previous_id = 0;
+    for (const CompactEntity &entity : entities) {
+        writer.writeVarUint(entity.net_id - previous_id);
+        previous_id = entity.net_id;
+
+        uint8_t fields = entity.fields & FIELD_ALL;
+        if (entity.entity_type != PLAYER_TYPE)
+            fields &= ~(FIELD_SHIELD | FIELD_SCORE);
+
+        writer.writeBits(clampBits(entity.entity_type, TYPE_BITS), TYPE_BITS);
+        writer.writeBits(fields, FIELD_BITS);
+        if (fields & FIELD_POSITION) {
+            writer.writeQuantized(entity.position_x, POSITION_MIN, POSITION_MAX,
+                                  POSITION_BITS);
+            writer.writeQuantized(entity.position_y, POSITION_MIN, POSITION_MAX,
+                                  POSITION_BITS);
+        }
+        if (fields & FIELD_HEALTH)
+            writer.writeBits(clampBits(entity.health, HEALTH_BITS), HEALTH_BITS);
+        if (fields & FIELD_FLAGS)
+            writer.writeBits(entity.flags & 0x01u, FLAG_BITS);
+        if (fields & FIELD_SHIELD)
+            writer.writeBits(clampBits(entity.shield, SHIELD_BITS), SHIELD_BITS);
+        if (fields & FIELD_SCORE)
+            writer.writeVarUint(entity.score);
+    }
+}
+
+/**
+ * @brief Decode entities written by encode()
+ * @return false if the data is truncated or inconsistent
+ */
+inline bool decode(BitReader &reader, std::vector<CompactEntity> &entities) {
+    uint32_t count = reader.readVarUint();
+    if (!reader.ok())
+        return false;
+
+    entities.clear();
+    uint32_t previous_id = 0;
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        CompactEntity entity;
+        entity.net_id = previous_id + reader.readVarUint();
+        previous_id = entity.net_id;
+
+        entity.entity_type = static_cast<uint8_t>(reader.readBits(TYPE_BITS));
+        entity.fields = static_cast<uint8_t>(reader.readBits(FIELD_BITS));
+        if (entity.fields & FIELD_POSITION) {
+            entity.position_x =
+                reader.readQuantized(POSITION_MIN, POSITION_MAX, POSITION_BITS);
+            entity.position_y =
+                reader.readQuantized(POSITION_MIN, POSITION_MAX, POSITION_BITS);
+        }
+        if (entity.fields & FIELD_HEALTH)
+            entity.health = reader.readBits(HEALTH_BITS);
+        if (entity.fields & FIELD_FLAGS)
+            entity.flags = static_cast<uint8_t>(reader.readBits(FLAG_BITS));
+        if (entity.fields & FIELD_SHIELD)
+            entity.shield = reader.readBits(SHIELD_BITS);
+        if (entity.fields & FIELD_SCORE)
+            entity.score = reader.readVarUint();
+        entities.push_back(entity);
+    }
+    return reader.ok();
+}
+
+} // namespace compact
+
+} // namespace network
@@ -1,4 +1,5 @@
 #pragma once
+#include "CompactEntityCodec.hpp"
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -69,7 +70,13 @@ enum class UDPMessageType : uint8_t {
     ENTITY_UPDATE = 0x11,
     ENTITY_DESTROY = 0x12,
     GAME_STATE = 0x13,
+    ENTITY_UPDATE_COMPACT = 0x14,
+    PROJECTILE_SPAWN = 0x15,
+    INPUT_ACK = 0x16,
+    ENTITY_DEFERRED = 0x17,
     PLAYER_INPUT = 0x20,
+    SNAPSHOT_ACK = 0x21,
+    INPUT_STATE = 0x22,
     VICTORY = 0x30
 };
 
@@ -165,7 +172,7 @@ struct EntityData {
 
 /**
  * @struct EntityUpdateData
- * @brief Entity update data from ENTITY_UPDATE
+ * @brief Entity update data from ENTITY_UPDATE or ENTITY_UPDATE_COMPACT
  */
 struct EntityUpdateData {
     uint32_t net_id;
@@ -176,6 +183,31 @@ struct EntityUpdateData {
     float position_y;
     uint32_t score;
     uint8_t flags = 0;
+    uint8_t fields = FIELD_ALL; ///< EntityField bits present in the update
+};
+
+/**
+ * @struct ProjectileSpawnData
+ * @brief Straight-line projectile from PROJECTILE_SPAWN
+ */
+struct ProjectileSpawnData {
+    uint32_t net_id;
+    EntityType entity_type;
+    uint32_t spawn_tick; ///< Server tick at which it was at the origin
+    float origin_x;
+    float origin_y;
+    float velocity_x; ///< Normalized units per second
+    float velocity_y;
+};
+
+/**
+ * @struct ProjectileSpawnBatch
+ * @brief Decoded PROJECTILE_SPAWN message
+ */
+struct ProjectileSpawnBatch {
+    uint32_t server_tick = 0; ///< Server tick when the message was sent
+    uint8_t tick_rate = 0;    ///< Server ticks per second
+    std::vector<ProjectileSpawnData> projectiles;
 };
 
 /**
@@ -187,6 +219,24 @@ struct PlayerInputData {
     Direction direction;
 };
 
+/**
+ * @struct InputFrameData
+ * @brief One sampled input frame for INPUT_STATE
+ */
+struct InputFrameData {
+    uint32_t sequence = 0; ///< Increases by one per sampled frame
+    uint8_t buttons = 0;   ///< network::InputButton bits
+};
+
+/**
+ * @struct InputAckData
+ * @brief Decoded INPUT_ACK
+ */
+struct InputAckData {
+    uint32_t snapshot_tick = 0;  ///< Snapshot the acknowledgement belongs to
+    uint32_t input_sequence = 0; ///< Newest INPUT_STATE frame it includes
+};
+
 /**
  * @struct ConnectionResult
  * @brief Result of connection attempt
@@ -44,6 +44,7 @@ struct UpdateEntityCommand {
     float position_y;
     uint32_t score;
     uint8_t flags = 0;
+    uint8_t fields = FIELD_ALL; ///< EntityField bits to apply, others are unchanged
 };
 
 /**
@@ -79,6 +80,7 @@ struct ConnectionStatusCommand {
  */
 struct PlayerAssignmentCommand {
     uint32_t player_net_id;
+    uint8_t tick_rate = 0; ///< Server ticks per second, 0 if not announced
 };
 
 /**
@@ -1,5 +1,7 @@
 #pragma once
 #include "../components.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace component {
@@ -19,19 +21,73 @@ struct network_entity {
           last_update_time(0.0f) {}
 };
 
+/**
+ * @struct position_sample
+ * @brief Server position (normalized) and the server time of its snapshot
+ */
+struct position_sample {
+    double time = 0.0;
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
 /**
  * @struct network_state
  * @brief Stores last known network state for interpolation
  */
 struct network_state {
+    static constexpr size_t MAX_SAMPLES = 8;
+
     position last_position;
-    velocity last_velocity;
+    velocity last_velocity; ///< Normalized units per second, for extrapolation
     uint32_t last_sequence;
     float interpolation_time;
 
+    std::array<position_sample, MAX_SAMPLES> samples; ///< Ring buffer
+    size_t sample_count;
+    size_t newest;
+    uint32_t last_sample_tick; ///< Snapshot tick of the newest sample
+
     network_state()
         : last_position(0.0f, 0.0f), last_velocity(0.0f, 0.0f),
-          last_sequence(0), interpolation_time(0.0f) {}
+          last_sequence(0), interpolation_time(0.0f), samples(),
+          sample_count(0), newest(0), last_sample_tick(0) {}
+
+    /**
+     * @brief Append a sample, dropping the oldest once full
+     *
+     * A sample with the same time as the newest one replaces it, so the
+     * messages of one snapshot arriving together yield a single sample.
+     */
+    void push_sample(double time, float x, float y) {
+        if (sample_count == 0 || time > samples[newest].time) {
+            if (sample_count > 0) {
+                newest = (newest + 1) % MAX_SAMPLES;
+            }
+            if (sample_count < MAX_SAMPLES) {
+                ++sample_count;
+            }
+        }
+        samples[newest] = {time, x, y};
+
+        if (sample_count > 1) {
+            const position_sample &previous = sample(1);
+            double elapsed = time - previous.time;
+            if (elapsed > 0.0) {
+                last_velocity.vx = static_cast<float>((x - previous.x) / elapsed);
+                last_velocity.vy = static_cast<float>((y - previous.y) / elapsed);
+            }
+        }
+        last_position.x = x;
+        last_position.y = y;
+    }
+
+    /**
+     * @brief Sample by age, 0 being the newest
+     */
+    const position_sample &sample(size_t age) const {
+        return samples[(newest + MAX_SAMPLES - age) % MAX_SAMPLES];
+    }
 };
 
 /**
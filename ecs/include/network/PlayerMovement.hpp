@@ -0,0 +1,61 @@
+#pragma once
+#include "CompactEntityCodec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace network {
+
+/**
+ * @brief Player movement rules shared by the server and client prediction
+ *
+ * Header-only so the server simulation and the client predictor run the
+ * exact same code. Positions are normalized (0.0-1.0).
+ */
+namespace movement {
+
+constexpr float PLAYER_MOVE_SPEED = 0.5f; ///< Normalized units per second
+
+/**
+ * @brief Velocity produced by the held directions, diagonals normalized
+ */
+inline void inputVelocity(bool up, bool down, bool left, bool right,
+                          float &vx, float &vy) {
+    vx = 0.0f;
+    vy = 0.0f;
+
+    if (up)    vy -= PLAYER_MOVE_SPEED;
+    if (down)  vy += PLAYER_MOVE_SPEED;
+    if (left)  vx -= PLAYER_MOVE_SPEED;
+    if (right) vx += PLAYER_MOVE_SPEED;
+
+    if ((up || down) && (left || right)) {
+        float length = std::sqrt(vx * vx + vy * vy);
+        if (length > 0) {
+            vx = (vx / length) * PLAYER_MOVE_SPEED;
+            vy = (vy / length) * PLAYER_MOVE_SPEED;
+        }
+    }
+}
+
+/**
+ * @brief Advance a player position by one step, clamped to the screen
+ */
+inline void stepPlayer(float &x, float &y, float vx, float vy, float dt) {
+    x = std::max(0.0f, std::min(x + vx * dt, 1.0f));
+    y = std::max(0.0f, std::min(y + vy * dt, 1.0f));
+}
+
+/**
+ * @brief Advance a player position from InputButton bits
+ */
+inline void stepPlayer(float &x, float &y, uint8_t buttons, float dt) {
+    float vx;
+    float vy;
+    inputVelocity(buttons & INPUT_UP, buttons & INPUT_DOWN,
+                  buttons & INPUT_LEFT, buttons & INPUT_RIGHT, vx, vy);
+    stepPlayer(x, y, vx, vy, dt);
+}
+
+} // namespace movement
+} // namespace network
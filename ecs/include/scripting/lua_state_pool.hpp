@@ -0,0 +1,91 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** lua_state_pool
+*/
+
+#pragma once
+#include "../lua_compat_fix.hpp"
+#include <memory>
+#include <mutex>
+#include <sol/sol.hpp>
+#include <string>
+#include <vector>
+
+namespace scripting {
+
+/**
+ * @brief A pooled Lua state and the scripts that loaded into it
+ */
+struct pooled_state {
+    sol::state lua;
+    std::vector<std::string> loaded; ///< Scripts that ran without error
+};
+
+/**
+ * @brief Pool of Lua states, one per thread calling into scripts
+ *
+ * A sol::state is not thread-safe, so each thread gets its own state,
+ * preloaded with every registered script. Scripts only read the globals
+ * passed to them before each call, so results do not depend on which
+ * state runs them. A state is returned to the pool when its thread exits
+ * and reused by the next thread that needs one.
+ */
+class lua_state_pool {
+  public:
+    static lua_state_pool &instance();
+
+    /**
+     * @brief Get the calling thread's state, creating it on first use
+     */
+    sol::state &local();
+
+    /**
+     * @brief Whether a script loaded into the calling thread's state
+     *
+     * Lets callers fall back without calling into a script that failed to
+     * load, instead of logging the same error on every call.
+     */
+    bool loaded(const char *script);
+
+    /**
+     * @brief Replace the scripts loaded in new states
+     * @note States already handed out keep the previous scripts
+     */
+    void set_scripts(const std::vector<std::string> &paths);
+
+    std::vector<std::string> scripts() const;
+
+    std::size_t created_states() const;
+
+    lua_state_pool(const lua_state_pool &) = delete;
+    lua_state_pool &operator=(const lua_state_pool &) = delete;
+
+  private:
+    lua_state_pool();
+
+    pooled_state &local_entry();
+    std::unique_ptr<pooled_state> acquire();
+    void release(std::unique_ptr<pooled_state> state);
+    std::unique_ptr<pooled_state> create_state() const;
+
+    friend struct state_lease;
+
+    mutable std::mutex _mutex;
+    std::vector<std::string> _scripts;
+    std::vector<std::unique_ptr<pooled_state>> _idle;
+    std::size_t _created = 0;
+};
+
+/**
+ * @brief Shortcut for lua_state_pool::instance().local()
+ */
+sol::state &local_state();
+
+/**
+ * @brief Shortcut for lua_state_pool::instance().loaded()
+ */
+bool script_loaded(const char *script);
+
+} // namespace scripting
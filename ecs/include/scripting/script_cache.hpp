@@ -0,0 +1,71 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** script_cache
+*/
+
+#pragma once
+#include "../lua_compat_fix.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scripting {
+
+/**
+ * @brief Compiled bytecode of the gameplay scripts
+ *
+ * Scripts are compiled once per process and the bytecode is stored in a
+ * `.cache` folder next to the sources, named after the script and the hash
+ * of its content. A cached file is only reused while the source it was
+ * built from is unchanged, so editing a script invalidates it. Since Lua
+ * does not verify bytecode, a cached file is only loaded if it matches the
+ * checksum written next to it and nobody but the current user can write
+ * to it or its folder; otherwise the source is compiled again.
+ */
+class script_cache {
+  public:
+    static script_cache &instance();
+
+    /**
+     * @brief Compile (or load from disk) every given script
+     */
+    void preload(const std::vector<std::string> &paths);
+
+    /**
+     * @brief Run a script in the given Lua state from its bytecode
+     * @return false if the script could not be compiled or raised an error
+     */
+    bool run(lua_State *L, const std::string &path);
+
+    script_cache(const script_cache &) = delete;
+    script_cache &operator=(const script_cache &) = delete;
+
+  private:
+    struct entry {
+        std::uint64_t hash = 0;
+        std::string bytecode;
+        bool valid = false;
+    };
+
+    script_cache() = default;
+
+    const entry &get(const std::string &path);
+    entry build(const std::string &path) const;
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, entry> _entries;
+};
+
+/**
+ * @brief Compile every pooled script and create the calling thread's state
+ *
+ * Meant to be called while loading a game, so the first weapon fire or AI
+ * tick does not parse scripts mid-frame.
+ */
+void preload_scripts();
+
+} // namespace scripting
@@ -0,0 +1,110 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** script_profiler
+*/
+
+#pragma once
+#include "../lua_compat_fix.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sol/sol.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace scripting {
+
+/**
+ * @brief Timing of one script function over the current window
+ */
+struct function_stats {
+    std::uint64_t calls = 0;         ///< Number of calls
+    std::chrono::nanoseconds total{}; ///< Time spent in all calls
+    std::chrono::nanoseconds max{};   ///< Slowest single call
+};
+
+/**
+ * @brief Records how much time and memory the gameplay scripts use
+ *
+ * Off unless enabled with set_enabled() or the RTYPE_SCRIPT_PROFILE
+ * environment variable. Once on, every call made through scripting::call()
+ * is timed into an accumulator owned by the calling thread, so threads
+ * running scripts on their own Lua state never wait on each other. dump()
+ * merges the accumulators and prints the figures gathered since the
+ * previous dump, which tells which user-edited script eats the frame budget.
+ */
+class script_profiler {
+  public:
+    static script_profiler &instance();
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled);
+
+    /**
+     * @brief Record one call in the calling thread's accumulator
+     * @param function Name of the called function, must outlive the profiler
+     * @param L State the call ran in, its memory is sampled now and then
+     */
+    void record(const char *function, std::chrono::nanoseconds elapsed,
+                lua_State *L);
+
+    /**
+     * @brief Print and reset the stats of the current window
+     * @param out Stream to print to
+     * @param window_seconds Length of the window, used for the frame share
+     */
+    void dump(std::ostream &out, float window_seconds);
+
+    std::unordered_map<std::string, function_stats> functions() const;
+
+    /**
+     * @brief Memory used by the Lua states of the threads still running
+     * scripts, in bytes
+     */
+    std::size_t memory() const;
+
+  private:
+    /**
+     * @brief Accumulator of one thread, dropped with its thread
+     */
+    struct thread_stats {
+        std::mutex mutex; ///< Only contended while the stats are merged
+        std::vector<std::pair<const char *, function_stats>> functions;
+        std::uint64_t calls = 0;  ///< Calls since the thread started
+        std::size_t memory = 0;   ///< Last sampled memory of its state
+    };
+
+    friend struct thread_slot;
+
+    script_profiler();
+
+    thread_stats &local();
+    void retire(const thread_stats &stats);
+    /**
+     * @brief Sum the retired and live accumulators
+     * @param reset Also empty them, under the lock the sum is taken with
+     */
+    void merge(bool reset, std::unordered_map<std::string, function_stats> &out,
+               std::size_t &memory, std::size_t &states) const;
+
+    std::atomic<bool> _enabled;
+    mutable std::mutex _mutex; ///< Guards the thread list and _retired
+    std::vector<std::shared_ptr<thread_stats>> _threads;
+    /// Calls of threads that exited since the last dump
+    mutable std::unordered_map<std::string, function_stats> _retired;
+};
+
+/**
+ * @brief Call a global script function and record it in the profiler
+ * @param function Name of the function, a string literal
+ */
+sol::protected_function_result call(sol::state &lua, const char *function);
+
+} // namespace scripting
@@ -10,6 +10,11 @@
 
 namespace network {
 
+namespace {
+// TCP header (4) + UDP_PORT (2) + SERVER_ID (2) + SERVER_IP (4) + LEVEL_ID (1)
+constexpr size_t GAME_START_TOKEN_OFFSET = 13;
+} // namespace
+
 ANetworkManager::ANetworkManager(std::unique_ptr<IIOContext> io_context)
     : io_context_(std::move(io_context)), tcp_socket_(nullptr),
       udp_socket_(nullptr), state_(ConnectionState::DISCONNECTED),
@@ -210,6 +215,16 @@ void ANetworkManager::processCompleteTCPMessage(
         if (complete_msg.size() >= 6) {
             udp_port_ =
                 (static_cast<uint16_t>(complete_msg[4]) << 8) | complete_msg[5];
+
+            // UDP_PORT, SERVER_ID, SERVER_IP, LEVEL_ID, then SESSION_TOKEN
+            uint64_t token = 0;
+            if (complete_msg.size() >= GAME_START_TOKEN_OFFSET + 8) {
+                for (size_t i = 0; i < 8; ++i) {
+                    token = (token << 8) |
+                            complete_msg[GAME_START_TOKEN_OFFSET + i];
+                }
+            }
+            session_token_ = token;
             std::cout << "TCP_GAME_START received, UDP Port: " << udp_port_
                       << std::endl;
             updateState(ConnectionState::GAME_STARTING);
@@ -268,6 +283,7 @@ void ANetworkManager::disconnect() {
 
     player_id_ = 0;
     udp_port_ = 0;
+    session_token_ = 0;
 }
 
 ConnectionState ANetworkManager::getConnectionState() const {
@@ -329,7 +345,21 @@ bool ANetworkManager::sendRawUDP(const std::vector<uint8_t> &data) {
         return false;
     }
 
-    size_t sent = udp_socket_->sendTo(data);
+    uint64_t token = session_token_;
+    if (token == 0) {
+        return udp_socket_->sendTo(data) > 0;
+    }
+
+    // The buffer keeps its capacity, sending allocates nothing once warm.
+    // The first ping leaves from the I/O thread, later sends from the game
+    std::lock_guard<std::mutex> lock(udp_send_mutex_);
+    udp_send_buffer_.clear();
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        udp_send_buffer_.push_back(static_cast<uint8_t>((token >> shift) & 0xFF));
+    }
+    udp_send_buffer_.insert(udp_send_buffer_.end(), data.begin(), data.end());
+
+    size_t sent = udp_socket_->sendTo(udp_send_buffer_);
     return sent > 0;
 }
 
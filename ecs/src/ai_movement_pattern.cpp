@@ -6,11 +6,11 @@
 */
 
 #include "../include/components.hpp"
-#include "../include/lua_compat_fix.hpp"
+#include "../include/scripting/lua_state_pool.hpp"
+#include "../include/scripting/script_profiler.hpp"
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
-#include <sol/sol.hpp>
 
 namespace component {
 
@@ -19,25 +19,14 @@ void ai_movement_pattern::apply_pattern(float &vx, float &vy, float pos_x,
 
     pattern_time += dt;
 
-    static sol::state lua;
-    static bool initialized = false;
-
-    if (!initialized) {
-        lua.open_libraries(sol::lib::base, sol::lib::math);
-
-        // Load external Lua script
-        try {
-            lua.script_file("scripts/ai_pattern.lua");
-        } catch (const sol::error &e) {
-            std::cerr << "[Lua Error] " << e.what() << std::endl;
-            vx = -base_speed;
-            vy = 0.0f;
-            return;
-        }
-
-        initialized = true;
+    if (!scripting::script_loaded("scripts/ai_pattern.lua")) {
+        vx = -base_speed;
+        vy = 0.0f;
+        return;
     }
 
+    sol::state &lua = scripting::local_state();
+
     // Pass parameters to Lua
     lua["pattern_type"] = pattern_type;
     lua["base_speed"] = base_speed;
@@ -50,8 +39,8 @@ void ai_movement_pattern::apply_pattern(float &vx, float &vy, float pos_x,
     lua["dt"] = dt;
 
     // Call Lua function
-    sol::protected_function pattern_func = lua["apply_pattern"];
-    sol::protected_function_result result = pattern_func();
+    sol::protected_function_result result =
+        scripting::call(lua, "apply_pattern");
 
     if (!result.valid()) {
         sol::error err = result;
@@ -1,8 +1,8 @@
 #include "../include/components.hpp"
-#include "../include/lua_compat_fix.hpp"
+#include "../include/scripting/lua_state_pool.hpp"
+#include "../include/scripting/script_profiler.hpp"
 #include <cmath>
 #include <iostream>
-#include <sol/sol.hpp>
 
 namespace component {
 
@@ -13,21 +13,11 @@ projectile_pattern::projectile_pattern(const std::string &type, float p1,
 void projectile_pattern::apply_pattern(float &vx, float &vy, float pos_x,
                                        float pos_y, float age, float speed,
                                        bool friendly) const {
-    static sol::state lua;
-    static bool initialized = false;
-
-    if (!initialized) {
-        lua.open_libraries(sol::lib::base, sol::lib::math);
-
-        try {
-            lua.script_file("scripts/projectile_pattern.lua");
-        } catch (const sol::error &e) {
-            std::cerr << "[Lua Error] " << e.what() << std::endl;
-            return;
-        }
+    // Without its script a projectile keeps its current velocity
+    if (!scripting::script_loaded("scripts/projectile_pattern.lua"))
+        return;
 
-        initialized = true;
-    }
+    sol::state &lua = scripting::local_state();
 
     // Pass parameters to Lua
     lua["pattern_type"] = pattern_type;
@@ -44,8 +34,8 @@ void projectile_pattern::apply_pattern(float &vx, float &vy, float pos_x,
     lua["vy"] = vy;
 
     // Call Lua function
-    sol::protected_function pattern_func = lua["apply_projectile_pattern"];
-    sol::protected_function_result result = pattern_func();
+    sol::protected_function_result result =
+        scripting::call(lua, "apply_projectile_pattern");
 
     if (!result.valid()) {
         sol::error err = result;
@@ -0,0 +1,114 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** lua_state_pool
+*/
+
+#include "../../include/scripting/lua_state_pool.hpp"
+#include "../../include/scripting/script_cache.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace scripting {
+
+namespace {
+
+const std::vector<std::string> DEFAULT_SCRIPTS = {
+    "scripts/weapon_fire.lua", "scripts/ai_pattern.lua",
+    "scripts/projectile_pattern.lua", "scripts/enemy_spawn.lua"};
+
+} // namespace
+
+/**
+ * @brief Owns the state of one thread and gives it back to the pool when
+ * the thread exits
+ */
+struct state_lease {
+    std::unique_ptr<pooled_state> state;
+
+    ~state_lease() {
+        if (state)
+            lua_state_pool::instance().release(std::move(state));
+    }
+};
+
+lua_state_pool::lua_state_pool() : _scripts(DEFAULT_SCRIPTS) {}
+
+lua_state_pool &lua_state_pool::instance() {
+    static lua_state_pool pool;
+    return pool;
+}
+
+pooled_state &lua_state_pool::local_entry() {
+    thread_local state_lease lease;
+
+    if (!lease.state)
+        lease.state = acquire();
+    return *lease.state;
+}
+
+sol::state &lua_state_pool::local() { return local_entry().lua; }
+
+bool lua_state_pool::loaded(const char *script) {
+    const std::vector<std::string> &scripts = local_entry().loaded;
+    return std::find(scripts.begin(), scripts.end(), script) != scripts.end();
+}
+
+void lua_state_pool::set_scripts(const std::vector<std::string> &paths) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _scripts = paths;
+    _idle.clear();
+}
+
+std::vector<std::string> lua_state_pool::scripts() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _scripts;
+}
+
+std::size_t lua_state_pool::created_states() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _created;
+}
+
+std::unique_ptr<pooled_state> lua_state_pool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_idle.empty()) {
+            std::unique_ptr<pooled_state> state = std::move(_idle.back());
+            _idle.pop_back();
+            return state;
+        }
+        ++_created;
+    }
+    return create_state();
+}
+
+void lua_state_pool::release(std::unique_ptr<pooled_state> state) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _idle.push_back(std::move(state));
+}
+
+std::unique_ptr<pooled_state> lua_state_pool::create_state() const {
+    std::vector<std::string> paths = scripts();
+    auto state = std::make_unique<pooled_state>();
+
+    state->lua.open_libraries(sol::lib::base, sol::lib::math);
+    for (const std::string &path : paths) {
+        if (script_cache::instance().run(state->lua.lua_state(), path))
+            state->loaded.push_back(path);
+        else
+            std::cerr << "[Lua Error] " << path
+                      << " not loaded, its callers use their fallback"
+                      << std::endl;
+    }
+    return state;
+}
+
+sol::state &local_state() { return lua_state_pool::instance().local(); }
+
+bool script_loaded(const char *script) {
+    return lua_state_pool::instance().loaded(script);
+}
+
+} // namespace scripting
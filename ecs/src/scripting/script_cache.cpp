@@ -0,0 +1,249 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** script_cache
+*/
+
+#include "../../include/scripting/script_cache.hpp"
+#include "../../include/scripting/lua_state_pool.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace scripting {
+
+namespace {
+
+constexpr const char *CACHE_DIR = ".cache";
+constexpr const char *CACHE_EXT = ".luac";
+constexpr const char *SUM_EXT = ".sum";
+
+std::uint64_t fnv1a(const std::string &data) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // Bytecode is only valid for the Lua version that produced it
+    hash ^= static_cast<std::uint64_t>(LUA_VERSION_NUM);
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+bool read_file(const fs::path &path, std::string &out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::ostringstream content;
+    content << file.rdbuf();
+    out = content.str();
+    return true;
+}
+
+int dump_writer(lua_State * /*L*/, const void *data, size_t size, void *ud) {
+    static_cast<std::string *>(ud)->append(static_cast<const char *>(data),
+                                           size);
+    return 0;
+}
+
+bool compile(const std::string &source, const std::string &chunkname,
+             std::string &bytecode) {
+    lua_State *L = luaL_newstate();
+    if (!L)
+        return false;
+
+    if (luaL_loadbuffer(L, source.data(), source.size(), chunkname.c_str()) !=
+        0) {
+        std::cerr << "[Lua Error] " << lua_tostring(L, -1) << std::endl;
+        lua_close(L);
+        return false;
+    }
+#if LUA_VERSION_NUM >= 503
+    lua_dump(L, dump_writer, &bytecode, 0);
+#else
+    lua_dump(L, dump_writer, &bytecode);
+#endif
+    lua_close(L);
+    return true;
+}
+
+bool loads(const std::string &bytecode, const std::string &chunkname) {
+    lua_State *L = luaL_newstate();
+    if (!L)
+        return false;
+    bool ok = luaL_loadbuffer(L, bytecode.data(), bytecode.size(),
+                              chunkname.c_str()) == 0;
+    lua_close(L);
+    return ok;
+}
+
+std::string to_hex(std::uint64_t value) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx",
+                  static_cast<unsigned long long>(value));
+    return hex;
+}
+
+fs::path cache_path(const fs::path &script, std::uint64_t hash) {
+    return script.parent_path() / CACHE_DIR /
+           (script.stem().string() + "." + to_hex(hash) + CACHE_EXT);
+}
+
+void remove_stale(const fs::path &keep) {
+    std::error_code ec;
+    const std::string prefix = keep.stem().stem().string() + ".";
+    fs::path keep_sum = keep;
+    keep_sum += SUM_EXT;
+
+    for (const auto &file : fs::directory_iterator(keep.parent_path(), ec)) {
+        const std::string name = file.path().filename().string();
+        const fs::path ext = file.path().extension();
+        if (file.path() != keep && file.path() != keep_sum &&
+            name.rfind(prefix, 0) == 0 && (ext == CACHE_EXT || ext == SUM_EXT))
+            fs::remove(file.path(), ec);
+    }
+}
+
+/**
+ * @brief Whether only the current user could have written a cache file
+ *
+ * Lua does not verify bytecode, so a cache file anyone else could write
+ * is never loaded. Elsewhere than POSIX the cache is write-only.
+ */
+bool trusted(const fs::path &path) {
+#if defined(__unix__) || defined(__APPLE__)
+    for (const fs::path &p : {path.parent_path(), path}) {
+        struct stat info;
+        if (::stat(p.c_str(), &info) != 0 || info.st_uid != ::getuid() ||
+            (info.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+            return false;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+/**
+ * @brief Read a cache file if it is trusted and matches its checksum
+ */
+bool read_cached(const fs::path &cached, std::string &bytecode) {
+    std::string sum;
+    fs::path sum_path = cached;
+    sum_path += SUM_EXT;
+
+    if (!trusted(cached) || !trusted(sum_path) ||
+        !read_file(sum_path, sum) || !read_file(cached, bytecode))
+        return false;
+    return sum == to_hex(fnv1a(bytecode));
+}
+
+void write_cached(const fs::path &cached, const std::string &bytecode) {
+    std::error_code ec;
+    fs::create_directories(cached.parent_path(), ec);
+    fs::permissions(cached.parent_path(), fs::perms::owner_all,
+                    fs::perm_options::replace, ec);
+
+    fs::path sum_path = cached;
+    sum_path += SUM_EXT;
+    std::ofstream out(cached, std::ios::binary | std::ios::trunc);
+    std::ofstream sum(sum_path, std::ios::binary | std::ios::trunc);
+    if (!out || !sum) {
+        std::cerr << "[Lua] could not write bytecode cache " << cached
+                  << std::endl;
+        return;
+    }
+    out.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+    sum << to_hex(fnv1a(bytecode));
+    fs::permissions(cached, fs::perms::owner_read | fs::perms::owner_write,
+                    fs::perm_options::replace, ec);
+    fs::permissions(sum_path, fs::perms::owner_read | fs::perms::owner_write,
+                    fs::perm_options::replace, ec);
+    remove_stale(cached);
+}
+
+} // namespace
+
+script_cache &script_cache::instance() {
+    static script_cache cache;
+    return cache;
+}
+
+void script_cache::preload(const std::vector<std::string> &paths) {
+    for (const std::string &path : paths)
+        get(path);
+}
+
+bool script_cache::run(lua_State *L, const std::string &path) {
+    const entry &script = get(path);
+    if (!script.valid)
+        return false;
+
+    const std::string chunkname = "@" + path;
+    if (luaL_loadbuffer(L, script.bytecode.data(), script.bytecode.size(),
+                        chunkname.c_str()) != 0 ||
+        lua_pcall(L, 0, 0, 0) != 0) {
+        std::cerr << "[Lua Error] " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+const script_cache::entry &script_cache::get(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(path);
+        if (it != _entries.end())
+            return it->second;
+    }
+
+    // Built without the lock so other threads are not held up by disk I/O.
+    // Two threads may build the same script, the first one stored wins.
+    entry built = build(path);
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.emplace(path, std::move(built)).first->second;
+}
+
+script_cache::entry script_cache::build(const std::string &path) const {
+    entry result;
+    std::string source;
+
+    if (!read_file(path, source)) {
+        std::cerr << "[Lua Error] cannot open " << path << std::endl;
+        return result;
+    }
+    result.hash = fnv1a(source);
+
+    const fs::path cached = cache_path(path, result.hash);
+    if (read_cached(cached, result.bytecode) &&
+        loads(result.bytecode, "@" + path)) {
+        result.valid = true;
+        return result;
+    }
+
+    result.bytecode.clear();
+    if (!compile(source, "@" + path, result.bytecode))
+        return result;
+    result.valid = true;
+    write_cached(cached, result.bytecode);
+    return result;
+}
+
+void preload_scripts() {
+    script_cache::instance().preload(lua_state_pool::instance().scripts());
+    lua_state_pool::instance().local();
+}
+
+} // namespace scripting
@@ -0,0 +1,205 @@
+/*
+** EPITECH PROJECT, 2025
+** R-TYPE
+** File description:
+** script_profiler
+*/
+
+#include "../../include/scripting/script_profiler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+namespace scripting {
+
+namespace {
+
+// Reading the memory of a state walks its allocator counters, once in a
+// while is enough for a figure printed every few seconds
+constexpr std::uint64_t MEMORY_SAMPLE_CALLS = 256;
+
+std::size_t state_memory(lua_State *L) {
+    const int kbytes = lua_gc(L, LUA_GCCOUNT, 0);
+    const int bytes = lua_gc(L, LUA_GCCOUNTB, 0);
+    return static_cast<std::size_t>(kbytes) * 1024 +
+           static_cast<std::size_t>(bytes);
+}
+
+double to_ms(std::chrono::nanoseconds d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+void add(function_stats &into, const function_stats &stats) {
+    into.calls += stats.calls;
+    into.total += stats.total;
+    into.max = std::max(into.max, stats.max);
+}
+
+} // namespace
+
+/**
+ * @brief Registers the accumulator of a thread and retires it on exit
+ */
+struct thread_slot {
+    std::shared_ptr<script_profiler::thread_stats> stats =
+        std::make_shared<script_profiler::thread_stats>();
+
+    thread_slot() {
+        script_profiler &profiler = script_profiler::instance();
+        std::lock_guard<std::mutex> lock(profiler._mutex);
+        profiler._threads.push_back(stats);
+    }
+
+    ~thread_slot() { script_profiler::instance().retire(*stats); }
+};
+
+script_profiler::script_profiler()
+    : _enabled(std::getenv("RTYPE_SCRIPT_PROFILE") != nullptr) {}
+
+script_profiler &script_profiler::instance() {
+    static script_profiler profiler;
+    return profiler;
+}
+
+void script_profiler::set_enabled(bool enabled) {
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+script_profiler::thread_stats &script_profiler::local() {
+    thread_local thread_slot slot;
+    return *slot.stats;
+}
+
+void script_profiler::record(const char *function,
+                             std::chrono::nanoseconds elapsed, lua_State *L) {
+    thread_stats &stats = local();
+    std::lock_guard<std::mutex> lock(stats.mutex);
+
+    // Callers pass literals, the pointer almost always matches
+    auto it = std::find_if(stats.functions.begin(), stats.functions.end(),
+                           [function](const auto &entry) {
+                               return entry.first == function ||
+                                      std::strcmp(entry.first, function) == 0;
+                           });
+    if (it == stats.functions.end()) {
+        stats.functions.emplace_back(function, function_stats{});
+        it = stats.functions.end() - 1;
+    }
+    add(it->second, {1, elapsed, elapsed});
+
+    if (stats.calls++ % MEMORY_SAMPLE_CALLS == 0)
+        stats.memory = state_memory(L);
+}
+
+void script_profiler::retire(const thread_stats &stats) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto &[name, function] : stats.functions)
+        add(_retired[name], function);
+
+    // Its state goes back to the pool, its memory is no longer in use
+    _threads.erase(std::remove_if(_threads.begin(), _threads.end(),
+                                  [&stats](const auto &thread) {
+                                      return thread.get() == &stats;
+                                  }),
+                   _threads.end());
+}
+
+void script_profiler::merge(
+    bool reset, std::unordered_map<std::string, function_stats> &out,
+    std::size_t &memory, std::size_t &states) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Swapped out under the same lock, a thread retiring meanwhile is kept
+    // for the next window
+    if (reset) {
+        out = std::move(_retired);
+        _retired.clear();
+    } else {
+        out = _retired;
+    }
+    memory = 0;
+    states = 0;
+
+    for (const auto &thread : _threads) {
+        std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        for (auto &[name, function] : thread->functions) {
+            add(out[name], function);
+            if (reset)
+                function = function_stats{};
+        }
+        if (thread->calls > 0) {
+            memory += thread->memory;
+            ++states;
+        }
+    }
+}
+
+void script_profiler::dump(std::ostream &out, float window_seconds) {
+    std::unordered_map<std::string, function_stats> functions;
+    std::size_t memory_bytes = 0;
+    std::size_t states = 0;
+    merge(true, functions, memory_bytes, states);
+
+    std::vector<std::pair<std::string, function_stats>> sorted;
+    for (auto &entry : functions) {
+        if (entry.second.calls > 0)
+            sorted.push_back(std::move(entry));
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second.total > b.second.total;
+    });
+
+    const double window_ms =
+        std::max(static_cast<double>(window_seconds) * 1000.0, 1.0);
+    out << "[Lua Profiler] " << std::fixed << std::setprecision(1)
+        << window_seconds << "s window, " << states << " state(s), "
+        << memory_bytes / 1024 << " KB" << std::endl;
+    for (const auto &[name, stats] : sorted) {
+        const double total = to_ms(stats.total);
+        const double avg = total / static_cast<double>(stats.calls);
+        out << "  " << std::left << std::setw(26) << name << std::right
+            << " calls=" << std::setw(7) << stats.calls << std::setprecision(3)
+            << " total=" << std::setw(9) << total << "ms"
+            << " avg=" << std::setw(7) << avg << "ms"
+            << " max=" << std::setw(7) << to_ms(stats.max) << "ms"
+            << std::setprecision(2) << " (" << total * 100.0 / window_ms
+            << "% of wall time)" << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+std::unordered_map<std::string, function_stats>
+script_profiler::functions() const {
+    std::unordered_map<std::string, function_stats> functions;
+    std::size_t memory = 0;
+    std::size_t states = 0;
+    merge(false, functions, memory, states);
+    return functions;
+}
+
+std::size_t script_profiler::memory() const {
+    std::unordered_map<std::string, function_stats> functions;
+    std::size_t memory = 0;
+    std::size_t states = 0;
+    merge(false, functions, memory, states);
+    return memory;
+}
+
+sol::protected_function_result call(sol::state &lua, const char *function) {
+    sol::protected_function func = lua[function];
+
+    script_profiler &profiler = script_profiler::instance();
+    if (!profiler.enabled())
+        return func();
+
+    const auto start = std::chrono::steady_clock::now();
+    sol::protected_function_result result = func();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    profiler.record(
+        function, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+        lua.lua_state());
+    return result;
+}
+
+} // namespace scripting
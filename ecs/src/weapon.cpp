@@ -1,9 +1,9 @@
 #include "../include/components.hpp"
 #include "../include/registery.hpp"
-#include "../include/lua_compat_fix.hpp"
+#include "../include/scripting/lua_state_pool.hpp"
+#include "../include/scripting/script_profiler.hpp"
 #include <cmath>
 #include <iostream>
-#include <sol/sol.hpp>
 
 namespace component {
 
@@ -13,21 +13,10 @@ void weapon::fire(registry &r, const position &shooter_pos, bool is_friendly) {
         return;
     }
 
-    static sol::state lua;
-    static bool initialized = false;
-
-    if (!initialized) {
-        lua.open_libraries(sol::lib::base, sol::lib::math);
-
-        try {
-            lua.script_file("scripts/weapon_fire.lua");
-        } catch (const sol::error &e) {
-            std::cerr << "[Lua Error] " << e.what() << std::endl;
-            return;
-        }
+    if (!scripting::script_loaded("scripts/weapon_fire.lua"))
+        return;
 
-        initialized = true;
-    }
+    sol::state &lua = scripting::local_state();
 
     // Expose registry and parameters to Lua
     lua["projectile_count"] = projectile_count;
@@ -66,8 +55,8 @@ void weapon::fire(registry &r, const position &shooter_pos, bool is_friendly) {
     };
 
     // Call Lua fire function
-    sol::protected_function fire_func = lua["fire_weapon"];
-    sol::protected_function_result result = fire_func();
+    sol::protected_function_result result =
+        scripting::call(lua, "fire_weapon");
 
     if (!result.valid()) {
         sol::error err = result;
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/CompactEntityCodec.hpp"
+#include <cmath>
+
+using namespace network;
+
+TEST_CASE("bits round-trip across byte boundaries", "[bitstream]") {
+    BitWriter writer;
+    writer.writeBits(0x5, 3);
+    writer.writeBits(0x1ABC, 13);
+    writer.writeBool(true);
+    writer.writeBits(0xFFFFFFFFu, 32);
+    REQUIRE(writer.sizeBytes() == 7);
+
+    BitReader reader(writer.data().data(), writer.sizeBytes());
+    REQUIRE(reader.readBits(3) == 0x5);
+    REQUIRE(reader.readBits(13) == 0x1ABC);
+    REQUIRE(reader.readBool());
+    REQUIRE(reader.readBits(32) == 0xFFFFFFFFu);
+    REQUIRE(reader.ok());
+    REQUIRE(reader.atEnd());
+}
+
+TEST_CASE("varints cost one byte per 7 bits", "[bitstream]") {
+    const std::pair<uint32_t, size_t> cases[] = {
+        {0, 1}, {127, 1}, {128, 2}, {16383, 2}, {16384, 3}, {0xFFFFFFFFu, 5}};
+
+    for (const auto &[value, size] : cases) {
+        BitWriter writer;
+        writer.writeVarUint(value);
+        REQUIRE(writer.sizeBytes() == size);
+
+        BitReader reader(writer.data().data(), writer.sizeBytes());
+        REQUIRE(reader.readVarUint() == value);
+        REQUIRE(reader.ok());
+    }
+}
+
+TEST_CASE("quantized values are clamped and within one step", "[bitstream]") {
+    BitWriter writer;
+    writer.writeQuantized(0.3f, -0.5f, 1.5f, 16);
+    writer.writeQuantized(-3.0f, -0.5f, 1.5f, 16);
+    writer.writeQuantized(9.0f, -0.5f, 1.5f, 16);
+
+    BitReader reader(writer.data().data(), writer.sizeBytes());
+    REQUIRE(std::fabs(reader.readQuantized(-0.5f, 1.5f, 16) - 0.3f) < 2.0f / 65535.0f);
+    REQUIRE(reader.readQuantized(-0.5f, 1.5f, 16) == -0.5f);
+    REQUIRE(reader.readQuantized(-0.5f, 1.5f, 16) == 1.5f);
+}
+
+TEST_CASE("reading past the end sets the error flag", "[bitstream]") {
+    const uint8_t byte = 0xFF;
+    BitReader reader(&byte, 1);
+    reader.readBits(6);
+    REQUIRE(reader.ok());
+    REQUIRE(reader.readBits(4) == 0);
+    REQUIRE_FALSE(reader.ok());
+}
+
+TEST_CASE("compact entities round-trip with only their listed fields", "[codec]") {
+    std::vector<CompactEntity> sent(3);
+    sent[0].net_id = 7;
+    sent[0].entity_type = compact::PLAYER_TYPE;
+    sent[0].position_x = 0.25f;
+    sent[0].position_y = 0.75f;
+    sent[0].health = 100;
+    sent[0].shield = 30;
+    sent[0].score = 123456;
+    sent[0].flags = 1;
+
+    sent[1].net_id = 1000;
+    sent[1].entity_type = 3;
+    sent[1].health = 5000; // Over 12 bits
+    sent[1].fields = FIELD_HEALTH;
+
+    sent[2].net_id = 1001;
+    sent[2].entity_type = 3;
+    sent[2].shield = 50; // Not a player, dropped
+    sent[2].fields = FIELD_POSITION | FIELD_SHIELD;
+    sent[2].position_x = 1.0f;
+
+    BitWriter writer;
+    compact::encode(writer, sent);
+
+    std::vector<CompactEntity> received;
+    BitReader reader(writer.data().data(), writer.sizeBytes());
+    REQUIRE(compact::decode(reader, received));
+    REQUIRE(received.size() == 3);
+
+    REQUIRE(received[0].net_id == 7);
+    REQUIRE(received[0].fields == FIELD_ALL);
+    REQUIRE(std::fabs(received[0].position_x - 0.25f) < 0.0001f);
+    REQUIRE(std::fabs(received[0].position_y - 0.75f) < 0.0001f);
+    REQUIRE(received[0].health == 100);
+    REQUIRE(received[0].shield == 30);
+    REQUIRE(received[0].score == 123456);
+    REQUIRE(received[0].flags == 1);
+
+    REQUIRE(received[1].net_id == 1000);
+    REQUIRE(received[1].fields == FIELD_HEALTH);
+    REQUIRE(received[1].health == (1u << compact::HEALTH_BITS) - 1);
+
+    REQUIRE(received[2].net_id == 1001);
+    REQUIRE(received[2].fields == FIELD_POSITION);
+    REQUIRE(received[2].shield == 0);
+}
+
+TEST_CASE("truncated compact updates are rejected", "[codec]") {
+    std::vector<CompactEntity> sent(2);
+    sent[0].net_id = 1;
+    sent[1].net_id = 2;
+
+    BitWriter writer;
+    compact::encode(writer, sent);
+
+    std::vector<CompactEntity> received;
+    BitReader reader(writer.data().data(), writer.sizeBytes() - 2);
+    REQUIRE_FALSE(compact::decode(reader, received));
+}
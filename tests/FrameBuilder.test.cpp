@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/protocol/FrameBuilder.hpp"
+
+namespace {
+
+std::string message(char tag, size_t size) { return std::string(size, tag); }
+
+} // namespace
+
+TEST_CASE("messages are packed whole up to the datagram limit", "[frame]") {
+    FrameBuilder frame;
+    frame.reset(true);
+    REQUIRE(frame.empty());
+
+    frame.append(message('a', 500));
+    frame.append(message('b', 500));
+    frame.append(message('c', 200));
+    REQUIRE(frame.size() == 1);
+    REQUIRE(frame.datagram(0).size() == FrameBuilder::MAX_DATAGRAM_SIZE);
+
+    // One more byte would cross the limit, it opens a new datagram
+    frame.append(message('d', 1));
+    REQUIRE(frame.size() == 2);
+    REQUIRE(frame.datagram(1) == "d");
+}
+
+TEST_CASE("an oversized message is sent alone", "[frame]") {
+    FrameBuilder frame;
+    frame.reset(true);
+
+    frame.append(message('a', 100));
+    frame.append(message('b', FrameBuilder::MAX_DATAGRAM_SIZE + 50));
+    frame.append(message('c', 100));
+    REQUIRE(frame.size() == 3);
+    REQUIRE(frame.datagram(1).size() == FrameBuilder::MAX_DATAGRAM_SIZE + 50);
+    REQUIRE(frame.datagram(2) == message('c', 100));
+}
+
+TEST_CASE("without aggregation every message gets its own datagram", "[frame]") {
+    FrameBuilder frame;
+    frame.reset(false);
+
+    frame.append("x");
+    frame.append("y");
+    REQUIRE(frame.size() == 2);
+    REQUIRE(frame.datagram(0) == "x");
+    REQUIRE(frame.datagram(1) == "y");
+}
+
+TEST_CASE("reset starts an empty frame over the previous buffers", "[frame]") {
+    FrameBuilder frame;
+    frame.reset(true);
+    frame.append(message('a', 1000));
+    frame.append(message('b', 1000));
+    REQUIRE(frame.size() == 2);
+
+    frame.reset(true);
+    REQUIRE(frame.empty());
+    frame.append("z");
+    REQUIRE(frame.size() == 1);
+    REQUIRE(frame.datagram(0) == "z");
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "gamelogic/GameLogic.hpp"
+
+namespace {
+
+// Two idle players, the enemy spawner only starts after a few seconds
+struct SnapshotFixture {
+    GameLogic game{std::make_shared<registry>(), 1, 60};
+    std::vector<EntityState> delta;
+
+    SnapshotFixture() {
+        game.createPlayer(1, 1, 0.1f, 0.5f);
+        game.createPlayer(2, 2, 0.1f, 0.7f);
+        game.start();
+    }
+
+    uint tick() {
+        game.step();
+        uint captured = game.captureSnapshot();
+        game.markEntitiesSynced();
+        return captured;
+    }
+};
+
+} // namespace
+
+TEST_CASE("a client without baseline gets every entity in full", "[snapshot]") {
+    SnapshotFixture f;
+    f.tick();
+
+    f.game.getDeltaSnapshot(0, f.delta);
+    REQUIRE(f.delta.size() == 2);
+    REQUIRE(f.delta[0].net_id == 1);
+    REQUIRE(f.delta[1].net_id == 2);
+    for (const EntityState &state : f.delta) {
+        REQUIRE(state.fields == network::FIELD_ALL);
+    }
+}
+
+TEST_CASE("nothing is sent when nothing changed since the baseline", "[snapshot]") {
+    SnapshotFixture f;
+    uint baseline = f.tick();
+    f.tick();
+    f.tick();
+
+    f.game.getDeltaSnapshot(baseline, f.delta);
+    REQUIRE(f.delta.empty());
+}
+
+TEST_CASE("only the fields that changed since the baseline are sent", "[snapshot]") {
+    SnapshotFixture f;
+    uint baseline = f.tick();
+
+    f.game.applyInputState(1, network::INPUT_RIGHT, false);
+    f.tick();
+    f.game.applyInputState(1, 0, false);
+    f.tick();
+    f.tick();
+
+    // The player stopped, but moved since the baseline
+    f.game.getDeltaSnapshot(baseline, f.delta);
+    REQUIRE(f.delta.size() == 1);
+    REQUIRE(f.delta[0].net_id == 1);
+    REQUIRE(f.delta[0].fields == network::FIELD_POSITION);
+}
+
+TEST_CASE("entities created after the baseline are sent in full", "[snapshot]") {
+    SnapshotFixture f;
+    uint baseline = f.tick();
+
+    f.game.createPlayer(3, 3, 0.1f, 0.3f);
+    f.tick();
+
+    f.game.getDeltaSnapshot(baseline, f.delta);
+    REQUIRE(f.delta.size() == 1);
+    REQUIRE(f.delta[0].net_id == 3);
+    REQUIRE(f.delta[0].fields == network::FIELD_ALL);
+}
+
+TEST_CASE("an unusable baseline falls back to a full snapshot", "[snapshot]") {
+    SnapshotFixture f;
+    uint baseline = f.tick();
+    uint latest = baseline;
+
+    SECTION("baseline newer than the latest snapshot") {
+        f.game.getDeltaSnapshot(latest + 1, f.delta);
+    }
+    SECTION("baseline overwritten in the ring") {
+        for (int i = 0; i < 130; ++i) {
+            latest = f.tick();
+        }
+        REQUIRE_FALSE(f.game.hasSnapshot(baseline));
+        f.game.getDeltaSnapshot(baseline, f.delta);
+    }
+
+    REQUIRE(f.delta.size() == 2);
+    REQUIRE(f.delta[0].fields == network::FIELD_ALL);
+    REQUIRE(f.delta[1].fields == network::FIELD_ALL);
+}
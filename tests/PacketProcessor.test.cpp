@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/PacketProcessor.hpp"
+
+using namespace network;
+
+namespace {
+
+UDPPacket packet(UDPMessageType type, uint32_t sequence) {
+    return UDPPacket{type, 0, sequence, {}};
+}
+
+std::vector<uint32_t> sequencesOf(const std::vector<UDPPacket> &packets) {
+    std::vector<uint32_t> sequences;
+    for (const UDPPacket &p : packets) {
+        sequences.push_back(p.sequence_num);
+    }
+    return sequences;
+}
+
+} // namespace
+
+TEST_CASE("unreliable messages are delivered as they arrive", "[reliable]") {
+    PacketProcessor processor;
+    processor.addPacket(packet(UDPMessageType::ENTITY_UPDATE, 9));
+    processor.addPacket(packet(UDPMessageType::ENTITY_UPDATE, 3));
+
+    REQUIRE(sequencesOf(processor.getProcessedPackets()) == std::vector<uint32_t>{9, 3});
+
+    uint32_t delivered = 0;
+    uint32_t bits = 0;
+    REQUIRE_FALSE(processor.takeReliableAck(delivered, bits));
+}
+
+TEST_CASE("reliable messages are held back until the gap is filled", "[reliable]") {
+    PacketProcessor processor;
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    processor.addPacket(packet(UDPMessageType::ENTITY_DESTROY, 3));
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 4));
+    REQUIRE(sequencesOf(processor.getProcessedPackets()) == std::vector<uint32_t>{1});
+
+    // Unreliable traffic is not blocked by the gap
+    processor.addPacket(packet(UDPMessageType::ENTITY_UPDATE, 0));
+    REQUIRE(processor.getProcessedPackets().size() == 1);
+
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 2));
+    REQUIRE(sequencesOf(processor.getProcessedPackets()) == std::vector<uint32_t>{2, 3, 4});
+}
+
+TEST_CASE("duplicates are dropped but still acknowledged", "[reliable]") {
+    PacketProcessor processor;
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    processor.getProcessedPackets();
+
+    uint32_t delivered = 0;
+    uint32_t bits = 0;
+    REQUIRE(processor.takeReliableAck(delivered, bits));
+    REQUIRE_FALSE(processor.takeReliableAck(delivered, bits));
+
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    REQUIRE(processor.getProcessedPackets().empty());
+    REQUIRE(processor.takeReliableAck(delivered, bits));
+    REQUIRE(delivered == 1);
+}
+
+TEST_CASE("the ack bitfield lists what arrived after the gap", "[reliable]") {
+    PacketProcessor processor;
+    uint32_t delivered = 99;
+    uint32_t bits = 99;
+
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 3));
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 6));
+    REQUIRE(processor.takeReliableAck(delivered, bits));
+    REQUIRE(delivered == 1);
+    REQUIRE(bits == 0b1001);
+
+    // Sequences too far past the gap are not listed
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 40));
+    processor.takeReliableAck(delivered, bits);
+    REQUIRE(bits == 0b1001);
+}
+
+TEST_CASE("sequences outside the window are ignored", "[reliable]") {
+    PacketProcessor processor;
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 5000));
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 0));
+
+    uint32_t delivered = 0;
+    uint32_t bits = 0;
+    processor.takeReliableAck(delivered, bits);
+    REQUIRE(delivered == 0);
+    REQUIRE(bits == 0);
+    REQUIRE(processor.getProcessedPackets().empty());
+}
+
+TEST_CASE("resetting the channel starts again from sequence 1", "[reliable]") {
+    PacketProcessor processor;
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 3));
+    processor.getProcessedPackets();
+
+    processor.resetReliableChannel();
+    processor.addPacket(packet(UDPMessageType::ENTITY_CREATE, 1));
+    REQUIRE(sequencesOf(processor.getProcessedPackets()) == std::vector<uint32_t>{1});
+
+    uint32_t delivered = 0;
+    uint32_t bits = 0;
+    processor.takeReliableAck(delivered, bits);
+    REQUIRE(delivered == 1);
+    REQUIRE(bits == 0);
+}
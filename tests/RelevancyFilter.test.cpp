@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "serverloop/RelevancyFilter.hpp"
+#include <algorithm>
+
+namespace {
+
+EntityState moved(uint32_t net_id, EntityType type) {
+    EntityState state{};
+    state.net_id = net_id;
+    state.type = type;
+    state.x = 0.9f;
+    state.y = 0.5f;
+    state.fields = network::FIELD_POSITION;
+    return state;
+}
+
+std::vector<EntityState> players(uint32_t count) {
+    std::vector<EntityState> states;
+    for (uint32_t id = 1; id <= count; ++id) {
+        states.push_back(moved(id, EntityType::PLAYER));
+    }
+    return states;
+}
+
+bool contains(const std::vector<EntityState> &states, uint32_t net_id) {
+    return std::any_of(states.begin(), states.end(),
+                       [net_id](const EntityState &s) { return s.net_id == net_id; });
+}
+
+// ENTITY_UPDATE records are 26 bytes, the default budget is 4800
+constexpr size_t RECORDS_IN_BUDGET = 4800 / 26;
+
+} // namespace
+
+TEST_CASE("distant enemies are sent every other broadcast and listed as deferred",
+          "[relevancy]") {
+    RelevancyFilter filter(60);
+    std::vector<EntityState> current = {moved(1, EntityType::PLAYER),
+                                        moved(2, EntityType::ENEMY)};
+    std::vector<EntityState> out;
+    std::vector<uint32_t> deferred;
+
+    filter.select(1, 1, 0, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.size() == 1);
+    REQUIRE(out[0].net_id == 1);
+    REQUIRE(deferred == std::vector<uint32_t>{2});
+
+    filter.select(1, 2, 0, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.size() == 2);
+    REQUIRE(deferred.empty());
+}
+
+TEST_CASE("entities over the byte budget go first in the next broadcast", "[relevancy]") {
+    RelevancyFilter filter(60);
+    std::vector<EntityState> current = players(200);
+    std::vector<EntityState> out;
+    std::vector<uint32_t> deferred;
+
+    filter.select(1, 1, 0, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.size() == RECORDS_IN_BUDGET);
+    REQUIRE(deferred.size() == 200 - RECORDS_IN_BUDGET);
+    for (uint32_t net_id : deferred) {
+        REQUIRE_FALSE(contains(out, net_id));
+    }
+
+    std::vector<uint32_t> held_back = deferred;
+    filter.select(1, 2, 0, nullptr, current, current, false, out, deferred);
+    for (uint32_t net_id : held_back) {
+        REQUIRE(contains(out, net_id));
+    }
+}
+
+TEST_CASE("a held back change is resent until a tick carrying it is acked",
+          "[relevancy]") {
+    RelevancyFilter filter(60);
+    std::vector<EntityState> current = {moved(7, EntityType::ENEMY)};
+    std::vector<EntityState> none;
+    std::vector<EntityState> out;
+    std::vector<uint32_t> deferred;
+
+    filter.select(1, 1, 0, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.empty());
+
+    // It stopped moving, the pending position still goes out
+    filter.select(1, 2, 0, nullptr, none, current, false, out, deferred);
+    REQUIRE(out.size() == 1);
+    REQUIRE(out[0].fields == network::FIELD_POSITION);
+
+    SECTION("acked") {
+        filter.select(1, 3, 2, nullptr, none, current, false, out, deferred);
+        REQUIRE(out.empty());
+        REQUIRE(deferred.empty());
+        filter.select(1, 4, 2, nullptr, none, current, false, out, deferred);
+        REQUIRE(out.empty());
+    }
+    SECTION("not acked") {
+        filter.select(1, 3, 1, nullptr, none, current, false, out, deferred);
+        REQUIRE(deferred == std::vector<uint32_t>{7});
+        filter.select(1, 4, 1, nullptr, none, current, false, out, deferred);
+        REQUIRE(out.size() == 1);
+    }
+    SECTION("destroyed") {
+        filter.select(1, 3, 1, nullptr, none, none, false, out, deferred);
+        filter.select(1, 4, 1, nullptr, none, none, false, out, deferred);
+        REQUIRE(out.empty());
+        REQUIRE(deferred.empty());
+    }
+}
+
+TEST_CASE("the budget is halved when acks fall behind", "[relevancy]") {
+    RelevancyFilter filter(60);
+    std::vector<EntityState> current = players(200);
+    std::vector<EntityState> out;
+    std::vector<uint32_t> deferred;
+
+    // Half a second of lag at 60 Hz is the limit
+    filter.select(1, 100, 10, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.size() == 2400 / 26);
+
+    // Clients are budgeted separately
+    filter.select(2, 100, 99, nullptr, current, current, false, out, deferred);
+    REQUIRE(out.size() > RECORDS_IN_BUDGET);
+}
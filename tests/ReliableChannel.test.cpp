@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/protocol/ReliableChannel.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Header-sized message, the payload byte tells the messages apart
+std::string message(char id) {
+    std::string data(9, '\0');
+    data[0] = 0x12;
+    data[8] = id;
+    return data;
+}
+
+uint32_t sequenceOf(const std::string &data) {
+    uint32_t sequence;
+    std::memcpy(&sequence, data.data() + 4, sizeof(sequence));
+    return ntohl(sequence);
+}
+
+std::vector<uint32_t> resent(ReliableChannel &channel, uint32_t tick) {
+    std::vector<uint32_t> sequences;
+    channel.resendExpired(tick, 0, [&sequences](const std::string &data) {
+        sequences.push_back(sequenceOf(data));
+    });
+    return sequences;
+}
+
+} // namespace
+
+TEST_CASE("messages are stamped with consecutive sequences from 1", "[reliable]") {
+    ReliableChannel channel;
+
+    for (uint32_t i = 1; i <= 3; ++i) {
+        const std::string &sent = channel.send(message('a'), 0);
+        REQUIRE(sequenceOf(sent) == i);
+        REQUIRE(sent[8] == 'a');
+        REQUIRE(channel.pending() == i);
+    }
+}
+
+TEST_CASE("messages shorter than the header are not stamped", "[reliable]") {
+    ReliableChannel channel;
+
+    const std::string &sent = channel.send("abc", 0);
+    REQUIRE(sent == "abc");
+}
+
+TEST_CASE("acknowledging a sequence releases everything up to it", "[reliable]") {
+    ReliableChannel channel;
+    for (char id = 'a'; id <= 'e'; ++id) {
+        channel.send(message(id), 0);
+    }
+
+    channel.acknowledge(3, 0);
+    REQUIRE(channel.pending() == 2);
+    REQUIRE(resent(channel, 1) == std::vector<uint32_t>{4, 5});
+
+    // A stale acknowledgement changes nothing
+    channel.acknowledge(2, 0);
+    REQUIRE(channel.pending() == 2);
+}
+
+TEST_CASE("the bitfield releases messages received after a gap", "[reliable]") {
+    ReliableChannel channel;
+    for (char id = 'a'; id <= 'e'; ++id) {
+        channel.send(message(id), 0);
+    }
+
+    // 1 delivered, 2 and 3 missing, 4 received
+    channel.acknowledge(1, 0b10);
+    REQUIRE(channel.pending() == 3);
+    REQUIRE(resent(channel, 1) == std::vector<uint32_t>{2, 3, 5});
+
+    // Nothing delivered yet, 2 and 5 received
+    ReliableChannel other;
+    for (char id = 'a'; id <= 'e'; ++id) {
+        other.send(message(id), 0);
+    }
+    other.acknowledge(0, 0b1001);
+    REQUIRE(resent(other, 1) == std::vector<uint32_t>{1, 3, 4});
+}
+
+TEST_CASE("only messages older than the resend delay are resent", "[reliable]") {
+    ReliableChannel channel;
+    channel.send(message('a'), 10);
+    channel.send(message('b'), 12);
+
+    std::vector<uint32_t> sequences;
+    auto collect = [&sequences](const std::string &data) {
+        sequences.push_back(sequenceOf(data));
+    };
+
+    channel.resendExpired(13, 5, collect);
+    REQUIRE(sequences.empty());
+
+    channel.resendExpired(15, 5, collect);
+    REQUIRE(sequences == std::vector<uint32_t>{1});
+
+    // The resend restarted the timer of the first message
+    sequences.clear();
+    channel.resendExpired(17, 5, collect);
+    REQUIRE(sequences == std::vector<uint32_t>{2});
+
+    sequences.clear();
+    channel.resendExpired(20, 5, collect);
+    REQUIRE(sequences == std::vector<uint32_t>{1});
+    REQUIRE(channel.pending() == 2);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/messages/RingQueue.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Ring>
+bool push(Ring &ring, int value) {
+    return ring.tryPush([value](int &slot) { slot = value; });
+}
+
+template <typename Ring>
+std::vector<int> drainAll(Ring &ring) {
+    std::vector<int> out;
+    ring.drain([&out](int &slot) { out.push_back(slot); });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("spsc ring rounds its capacity up and refuses pushes when full", "[ring]") {
+    SpscRing<int> ring(3);
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(push(ring, i));
+    }
+    REQUIRE_FALSE(push(ring, 4));
+
+    REQUIRE(drainAll(ring) == std::vector<int>{0, 1, 2, 3});
+    REQUIRE(drainAll(ring).empty());
+}
+
+TEST_CASE("spsc ring keeps fifo order across wrap-around", "[ring]") {
+    SpscRing<int> ring(4);
+    std::vector<int> received;
+
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(push(ring, 2 * i));
+        REQUIRE(push(ring, 2 * i + 1));
+        for (int value : drainAll(ring)) {
+            received.push_back(value);
+        }
+    }
+
+    REQUIRE(received.size() == 20);
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE(received[i] == i);
+    }
+}
+
+TEST_CASE("ring slots keep their buffers between uses", "[ring]") {
+    SpscRing<std::string> ring(1);
+    REQUIRE(ring.tryPush([](std::string &slot) { slot.assign(512, 'x'); }));
+    ring.drain([](std::string &) {});
+
+    size_t capacity = 0;
+    REQUIRE(ring.tryPush([&capacity](std::string &slot) {
+        capacity = slot.capacity();
+        slot.assign("y");
+    }));
+    REQUIRE(capacity >= 512);
+}
+
+TEST_CASE("mpsc ring refuses pushes when full and frees slots on drain", "[ring]") {
+    MpscRing<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(push(ring, i));
+    }
+    REQUIRE_FALSE(push(ring, 4));
+
+    REQUIRE(drainAll(ring) == std::vector<int>{0, 1, 2, 3});
+    REQUIRE(push(ring, 5));
+    REQUIRE(drainAll(ring) == std::vector<int>{5});
+}
+
+TEST_CASE("mpsc ring delivers every push of concurrent producers in order", "[ring]") {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    MpscRing<int> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                while (!push(ring, p * PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Values of one producer must come out in the order it pushed them
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        received += static_cast<int>(ring.drain([&](int &value) {
+            int producer = value / PER_PRODUCER;
+            ordered = ordered && value % PER_PRODUCER == next[producer];
+            ++next[producer];
+        }));
+    }
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    REQUIRE(ordered);
+    REQUIRE(drainAll(ring).empty());
+    for (int count : next) {
+        REQUIRE(count == PER_PRODUCER);
+    }
+}
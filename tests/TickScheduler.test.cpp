@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "serverloop/TickScheduler.hpp"
+
+using clock_type = TickScheduler::clock;
+
+static clock_type::duration periodOf(uint32_t tick_rate) {
+    return std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(1.0 / tick_rate));
+}
+
+TEST_CASE("unsupported tick rates fall back to 60 Hz", "[tick]") {
+    REQUIRE(TickScheduler::isSupportedRate(30));
+    REQUIRE(TickScheduler::isSupportedRate(120));
+    REQUIRE_FALSE(TickScheduler::isSupportedRate(25));
+
+    TickScheduler scheduler(25);
+    REQUIRE(scheduler.getTickRate() == 60);
+}
+
+TEST_CASE("a tick started on time moves the deadline by one period", "[tick]") {
+    TickScheduler scheduler(60);
+    auto deadline = scheduler.nextDeadline();
+    auto period = periodOf(60);
+
+    scheduler.tickStarted(deadline);
+    REQUIRE(scheduler.nextDeadline() == deadline + period);
+
+    // Waking up slightly late from a sleep is not an overrun
+    scheduler.tickStarted(scheduler.nextDeadline() + std::chrono::microseconds(500));
+    REQUIRE(scheduler.nextDeadline() == deadline + 2 * period);
+    REQUIRE(scheduler.getOverrunCount() == 0);
+}
+
+TEST_CASE("a late tick is an overrun but keeps the schedule", "[tick]") {
+    TickScheduler scheduler(60);
+    auto deadline = scheduler.nextDeadline();
+    auto period = periodOf(60);
+
+    scheduler.tickStarted(deadline + std::chrono::milliseconds(5));
+    REQUIRE(scheduler.getOverrunCount() == 1);
+    REQUIRE(scheduler.nextDeadline() == deadline + period);
+}
+
+TEST_CASE("falling far behind restarts the schedule", "[tick]") {
+    TickScheduler scheduler(60);
+    auto late = scheduler.nextDeadline() + std::chrono::milliseconds(200);
+
+    scheduler.tickStarted(late);
+    REQUIRE(scheduler.getOverrunCount() == 1);
+    // No burst of catch-up ticks, the next one is a period after now
+    REQUIRE(scheduler.nextDeadline() > late);
+    REQUIRE(scheduler.nextDeadline() < late + std::chrono::milliseconds(20));
+}
+
+TEST_CASE("waitForNextTick returns at or after the deadline", "[tick]") {
+    TickScheduler scheduler(120);
+    auto deadline = scheduler.nextDeadline();
+
+    scheduler.waitForNextTick();
+    REQUIRE(clock_type::now() >= deadline);
+    REQUIRE(scheduler.nextDeadline() > deadline);
+}